@@ -24,30 +24,87 @@ class CommandBuffer {
  ~CommandBuffer();
 }
 
+class Fence {
+ ~Fence();
+  IsReady() : bool;
+  Wait() : bool;
+}
+
 class Queue {
  ~Queue();
   Submit(commandBuffer : &CommandBuffer);
+  Submit(commandBuffers : &[]*CommandBuffer);
+  OnSubmittedWorkDone() : *Fence;
 }
 
+enum Feature { Subgroups, ShaderF16 }
+
 class Device {
   Device();
  ~Device();
   GetQueue() : *Queue;
+  HasFeature(feature : Feature) : bool;
+  GetPipelineCacheHits() : uint;
+  GetPipelineCacheMisses() : uint;
+  ProcessEvents();
+}
+
+class TransientPool {
+  TransientPool(device : &Device, maxCachedBytes = 268435456u, maxIdleFrames = 3u);
+ ~TransientPool();
+  NextFrame();
+  GetCachedBytes() : uint;
 }
 
 class CommandEncoder;
 
+class MapRequest {
+ ~MapRequest();
+  IsReady() : bool;
+  Wait() : bool;
+}
+
 class Buffer<T> {
   Buffer(device : &Device, size : uint = 1u);
   Buffer(device : &Device, t : &T);
+  Buffer(pool : &TransientPool, size : uint = 1u);
  ~Buffer();
   Set(data : &T);
+  SetRange(data : &T, offset : uint, count : uint);
+  SetElement(index : uint, data : &T) dynamic;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<T>);
   deviceonly MapRead() uniform : *readonly uniform T;
   deviceonly MapWrite() writeonly storage : *writeonly storage T;
   deviceonly Map() storage : *storage T;
   MapRead() hostreadable : *readonly T;
   MapWrite() hostwriteable : *writeonly T;
+  MapReadAsync() hostreadable : *MapRequest;
+  MapWriteAsync() hostwriteable : *MapRequest;
+}
+
+class ReadbackRing<T> {
+  ReadbackRing(device : &Device, size : uint = 1u, count : uint = 3u);
+ ~ReadbackRing();
+  Copy(encoder : &CommandEncoder, source : &Buffer<T>) : bool;
+  GetLatest() : *readonly T;
+  GetLatestFrame() : uint;
+}
+
+class QuerySet {
+  QuerySet(device : &Device, count : uint);
+ ~QuerySet();
+  IsSupported() : bool;
+}
+
+class GPUProfiler {
+  GPUProfiler(device : &Device, maxPasses = 16u);
+ ~GPUProfiler();
+  IsSupported() : bool;
+  Resolve(encoder : &CommandEncoder);
+  Update();
+  GetPassCount() : uint;
+  GetPassDuration(pass : uint) : float;
+  GetLatestFrame() : uint;
 }
 
 class DepthStencilState {
@@ -94,16 +151,42 @@ class BlendState {
   var alpha : BlendComponent;
 }
 
+class PipelineConstants {
+  PipelineConstants();
+ ~PipelineConstants();
+  Set(name : &[]ubyte, value : double);
+}
+
 class RenderPipeline<T> {
-  RenderPipeline(device : &Device, primitiveTopology = PrimitiveTopology.TriangleList, frontFace = FrontFace.CCW, cullMode = CullMode.None, depthStencilState : &DepthStencilState = {}, blendState : &BlendState = {});
+  RenderPipeline(device : &Device, primitiveTopology : PrimitiveTopology = PrimitiveTopology.TriangleList, frontFace : FrontFace = FrontFace.CCW, cullMode : CullMode = CullMode.None, depthStencilState : &DepthStencilState = {}, blendState : &BlendState = {});
+  RenderPipeline(device : &Device, constants : &PipelineConstants, primitiveTopology : PrimitiveTopology = PrimitiveTopology.TriangleList, frontFace : FrontFace = FrontFace.CCW, cullMode : CullMode = CullMode.None, depthStencilState : &DepthStencilState = {}, blendState : &BlendState = {});
  ~RenderPipeline();
 }
 
 class ComputePipeline<T> {
   ComputePipeline(device : &Device);
+  ComputePipeline(device : &Device, constants : &PipelineConstants);
  ~ComputePipeline();
 }
 
+class AsyncRenderPipeline<T> {
+  AsyncRenderPipeline(device : &Device, primitiveTopology : PrimitiveTopology = PrimitiveTopology.TriangleList, frontFace : FrontFace = FrontFace.CCW, cullMode : CullMode = CullMode.None, depthStencilState : &DepthStencilState = {}, blendState : &BlendState = {});
+  AsyncRenderPipeline(device : &Device, constants : &PipelineConstants, primitiveTopology : PrimitiveTopology = PrimitiveTopology.TriangleList, frontFace : FrontFace = FrontFace.CCW, cullMode : CullMode = CullMode.None, depthStencilState : &DepthStencilState = {}, blendState : &BlendState = {});
+ ~AsyncRenderPipeline();
+  IsReady() : bool;
+  Wait();
+  Get() : *RenderPipeline<T>;
+}
+
+class AsyncComputePipeline<T> {
+  AsyncComputePipeline(device : &Device);
+  AsyncComputePipeline(device : &Device, constants : &PipelineConstants);
+ ~AsyncComputePipeline();
+  IsReady() : bool;
+  Wait();
+  Get() : *ComputePipeline<T>;
+}
+
 class BindGroup<T> {
   BindGroup(device : &Device, data : &T);
  ~BindGroup();
@@ -128,6 +211,22 @@ class VertexInput<T> {
  ~VertexInput();
 }
 
+class PackedVertexInput<VF> {
+  PackedVertexInput(buffer : &vertex Buffer<[]VF:HostType>);
+  deviceonly Get() : VF:DeviceType;
+ ~PackedVertexInput();
+}
+
+class VertexQuantizer {
+ ~VertexQuantizer();
+  static ToUnorm8x4(src : &[]float<4>, dst : &writeonly []ubyte<4>);
+  static ToSnorm8x4(src : &[]float<4>, dst : &writeonly []byte<4>);
+  static ToUnorm16x4(src : &[]float<4>, dst : &writeonly []ushort<4>);
+  static ToSnorm16x4(src : &[]float<4>, dst : &writeonly []short<4>);
+  static ToFloat16x4(src : &[]float<4>, dst : &writeonly []half<4>);
+  static ToUnorm10_10_10_2(src : &[]float<4>, dst : &writeonly []uint);
+}
+
 class ColorOutput<PF> {
   deviceonly Set(value : PF:DeviceType<4>);
  ~ColorOutput();
@@ -187,10 +286,12 @@ class Texture1D<PF> {
   CreateSampleableView(baseMipLevel = 0u, mipLevelCount = 0u) sampleable : *SampleableTexture1D<PF:DeviceType>;
   CreateStorageView(mipLevel = 0u) : *storage Texture1D<PF>;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, width : uint, origin = 0u, mipLevel = 0u);
+  Write(data : &[]PF:HostType, width : uint, origin = 0u, mipLevel = 0u);
 }
 
 class Texture2D<PF> {
   Texture2D(device : &Device, size : uint<2>, mipLevelCount = 1u);
+  Texture2D(pool : &TransientPool, size : uint<2>, mipLevelCount = 1u);
  ~Texture2D();
   GetSize(mipLevel = 0u) : uint<2>;
   MinBufferWidth() : uint;
@@ -200,6 +301,9 @@ class Texture2D<PF> {
   CreateColorOutput(loadOp = LoadOp.Load, storeOp = StoreOp.Store, clearValue = float<4>(0.0, 0.0, 0.0, 0.0)) renderable : *ColorOutput<PF>;
   CreateDepthStencilOutput(depthLoadOp = LoadOp.Load, depthStoreOp = StoreOp.Store, depthClearValue = 1.0, stencilLoadOp = LoadOp.Undefined, stencilStoreOp = StoreOp.Undefined, stencilClearValue = 0) renderable : *DepthStencilOutput<PF>;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<2>, origin = uint<2>{0, 0}, mipLevel = 0u);
+  CopyToBuffer(encoder : &CommandEncoder, dest : &Buffer<[]PF:HostType>, size : uint<2>, origin = uint<2>{0, 0}, mipLevel = 0u);
+  Write(data : &[]PF:HostType, size : uint<2>, origin = uint<2>{0, 0}, mipLevel = 0u);
+  GenerateMipmaps(encoder : &CommandEncoder) sampleable;
 }
 
 class Texture2DArray<PF> {
@@ -212,6 +316,8 @@ class Texture2DArray<PF> {
   CreateRenderableView(layee : uint, mipLevel = 0u) : *renderable Texture2D<PF>;
   CreateStorageView(layer : uint, mipLevel = 0u) : *storage Texture2DArray<PF>;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<2>, layer : uint, numLayers = 1u, origin = uint<2>{0, 0}, mipLevel = 0u);
+  Write(data : &[]PF:HostType, size : uint<2>, layer : uint, numLayers = 1u, origin = uint<2>{0, 0}, mipLevel = 0u);
+  GenerateMipmaps(encoder : &CommandEncoder) sampleable;
 }
 
 class Texture3D<PF> {
@@ -223,6 +329,8 @@ class Texture3D<PF> {
   CreateRenderableView(depth : uint, mipLevel = 0u) : *renderable Texture2D<PF>;
   CreateStorageView(depth : uint, mipLevel = 0u) : *storage Texture3D<PF>;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<3>, origin = uint<3>{0, 0, 0}, mipLevel = 0u);
+  Write(data : &[]PF:HostType, size : uint<3>, origin = uint<3>{0, 0, 0}, mipLevel = 0u);
+  GenerateMipmaps(encoder : &CommandEncoder) sampleable;
 }
 
 class TextureCube<PF> {
@@ -234,32 +342,66 @@ class TextureCube<PF> {
   CreateRenderableView(face : uint, mipLevel = 0u) : *renderable Texture2D<PF>;
   CreateStorageView(face : uint, mipLevel = 0u) : *storage TextureCube<PF>;
   CopyFromBuffer(encoder : &CommandEncoder, source : &Buffer<[]PF:HostType>, size : uint<2>, face : uint, numFaces = 1u, origin = uint<2>{0, 0}, mipLevel = 0u);
+  Write(data : &[]PF:HostType, size : uint<2>, face : uint, numFaces = 1u, origin = uint<2>{0, 0}, mipLevel = 0u);
+  GenerateMipmaps(encoder : &CommandEncoder) sampleable;
 }
 
 class CommandEncoder {
   CommandEncoder(device : &Device);
  ~CommandEncoder();
+  ResolveQuerySet(querySet : &QuerySet, firstQuery : uint, queryCount : uint, destination : &storage Buffer<[]uint<2>>);
   Finish() : *CommandBuffer;
 }
 
 class RenderPass<T> {
   RenderPass(encoder : &CommandEncoder, data : &T);
+  RenderPass(encoder : &CommandEncoder, data : &T, querySet : &QuerySet, beginningOfPassWriteIndex : uint, endOfPassWriteIndex : uint);
+  RenderPass(encoder : &CommandEncoder, data : &T, profiler : &GPUProfiler);
   RenderPass(base : &RenderPass<T:BaseClass>);
  ~RenderPass();
   Draw(vertexCount : uint, instanceCount : uint, firstVertex : uint, firstInstance : uint);
-  DrawIndexed(indexCount : uint, instanceCount : uint, firstIndex : uint, baseVertex : uint, firstIntance : uint);
+  DrawIndexed(indexCount : uint, instanceCount : uint, firstIndex : uint, baseVertex : uint, firstInstance : uint);
+  DrawIndirect(indirectBuffer : &indirect Buffer<[]uint>, indirectOffset : uint);
+  DrawIndexedIndirect(indirectBuffer : &indirect Buffer<[]uint>, indirectOffset : uint);
   SetPipeline(pipeline : &RenderPipeline<T>);
   Set(data : &T);
+  Set(data : &T, dynamicIndices : &[]uint);
+  GetCommandsIssued() : uint;
+  GetCommandsSkipped() : uint;
+  ExecuteBundles(bundles : &[]*RenderBundle<T>);
   End();
 }
 
+class RenderBundle<T> {
+ ~RenderBundle();
+}
+
+class RenderBundleEncoder<T> {
+  RenderBundleEncoder(device : &Device);
+ ~RenderBundleEncoder();
+  Draw(vertexCount : uint, instanceCount : uint, firstVertex : uint, firstInstance : uint);
+  DrawIndexed(indexCount : uint, instanceCount : uint, firstIndex : uint, baseVertex : uint, firstInstance : uint);
+  DrawIndirect(indirectBuffer : &indirect Buffer<[]uint>, indirectOffset : uint);
+  DrawIndexedIndirect(indirectBuffer : &indirect Buffer<[]uint>, indirectOffset : uint);
+  SetPipeline(pipeline : &RenderPipeline<T>);
+  Set(data : &T);
+  Set(data : &T, dynamicIndices : &[]uint);
+  Finish() : *RenderBundle<T>;
+}
+
 class ComputePass<T> {
   ComputePass(encoder : &CommandEncoder, data : &T);
+  ComputePass(encoder : &CommandEncoder, data : &T, querySet : &QuerySet, beginningOfPassWriteIndex : uint, endOfPassWriteIndex : uint);
+  ComputePass(encoder : &CommandEncoder, data : &T, profiler : &GPUProfiler);
   ComputePass(base : &ComputePass<T:BaseClass>);
  ~ComputePass();
   Dispatch(workgroupCountX : uint, workgroupCountY : uint, workgroupCountZ : uint);
+  DispatchIndirect(indirectBuffer : &indirect Buffer<[]uint>, indirectOffset : uint);
   SetPipeline(pipeline : &ComputePipeline<T>);
   Set(data : &T);
+  Set(data : &T, dynamicIndices : &[]uint);
+  GetCommandsIssued() : uint;
+  GetCommandsSkipped() : uint;
   End();
 }
 
@@ -359,11 +501,54 @@ class Math {
   static transpose(m : float<4,4>) : float<4,4>;
 }
 
+class Subgroup {
+ ~Subgroup();
+  deviceonly static Size() : uint;
+  deviceonly static InvocationId() : uint;
+  deviceonly static Elect() : bool;
+  deviceonly static Ballot(predicate : bool) : uint<4>;
+  deviceonly static BroadcastFirst(value : int) : int;
+  deviceonly static BroadcastFirst(value : uint) : uint;
+  deviceonly static BroadcastFirst(value : float) : float;
+  deviceonly static BroadcastFirst(value : float<4>) : float<4>;
+  deviceonly static Broadcast(value : int, id : uint) : int;
+  deviceonly static Broadcast(value : uint, id : uint) : uint;
+  deviceonly static Broadcast(value : float, id : uint) : float;
+  deviceonly static Broadcast(value : float<4>, id : uint) : float<4>;
+  deviceonly static Shuffle(value : int, id : uint) : int;
+  deviceonly static Shuffle(value : uint, id : uint) : uint;
+  deviceonly static Shuffle(value : float, id : uint) : float;
+  deviceonly static Shuffle(value : float<4>, id : uint) : float<4>;
+  deviceonly static Add(value : int) : int;
+  deviceonly static Add(value : uint) : uint;
+  deviceonly static Add(value : float) : float;
+  deviceonly static Add(value : float<4>) : float<4>;
+  deviceonly static Min(value : int) : int;
+  deviceonly static Min(value : uint) : uint;
+  deviceonly static Min(value : float) : float;
+  deviceonly static Max(value : int) : int;
+  deviceonly static Max(value : uint) : uint;
+  deviceonly static Max(value : float) : float;
+  deviceonly static InclusiveAdd(value : int) : int;
+  deviceonly static InclusiveAdd(value : uint) : uint;
+  deviceonly static InclusiveAdd(value : float) : float;
+  deviceonly static ExclusiveAdd(value : int) : int;
+  deviceonly static ExclusiveAdd(value : uint) : uint;
+  deviceonly static ExclusiveAdd(value : float) : float;
+}
+
+class DecodeRequest {
+ ~DecodeRequest();
+  IsReady() : bool;
+  Wait() : bool;
+}
+
 class Image<PF> {
   Image(encodedImage : *[]ubyte);
  ~Image();
-  GetSize() : uint<2>;
-  Decode(buffer : &writeonly []PF:HostType, bufferWidth : uint);
+  GetSize(scale = 1u) : uint<2>;
+  Decode(buffer : &writeonly []PF:HostType, bufferWidth : uint, scale = 1u);
+  DecodeAsync(buffer : *writeonly []PF:HostType, bufferWidth : uint, scale = 1u) : *DecodeRequest;
 }
 
 enum EventType { MouseMove, MouseDown, MouseUp, TouchStart, TouchMove, TouchEnd, Resize, Unknown }
@@ -436,15 +621,15 @@ class BGRA8unormSRGB : PixelFormat<float, ubyte<4>> {}
 
 class R16uint : PixelFormat<uint, ushort> {}
 class R16sint : PixelFormat<int, short> {}
-class R16float : PixelFormat<float, ushort> {}
+class R16float : PixelFormat<float, half> {}
 
 class RG16uint : PixelFormat<uint, ushort<2>> {}
 class RG16sint : PixelFormat<int, short<2>> {}
-class RG16float : PixelFormat<float, ushort<2>> {}
+class RG16float : PixelFormat<float, half<2>> {}
 
 class RGBA16uint : PixelFormat<uint, ushort<4>> {}
 class RGBA16sint : PixelFormat<int, short<4>> {}
-class RGBA16float : PixelFormat<float, ushort<4>> {}
+class RGBA16float : PixelFormat<float, half<4>> {}
 
 class R32uint : PixelFormat<uint, uint> {}
 class R32sint : PixelFormat<int, int> {}
@@ -464,3 +649,12 @@ class RG11B10ufloat : PixelFormat<float, uint> {}
 class Depth24Plus : PixelFormat<float, uint> {}
 
 class PreferredPixelFormat : PixelFormat<float, ubyte<4>> {}
+
+class VertexFormat<DeviceType, HostType> {}
+
+class Unorm8x4 : VertexFormat<float<4>, ubyte<4>> {}
+class Snorm8x4 : VertexFormat<float<4>, byte<4>> {}
+class Unorm16x4 : VertexFormat<float<4>, ushort<4>> {}
+class Snorm16x4 : VertexFormat<float<4>, short<4>> {}
+class Float16x4 : VertexFormat<float<4>, half<4>> {}
+class Unorm10_10_10_2 : VertexFormat<float<4>, uint> {}
@@ -21,9 +21,17 @@
 
 #include <assert.h>
 #include <stdio.h>
+#include <stdlib.h>
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <memory>
+#include <set>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -34,6 +42,9 @@
 #include <ast/native_class.h>
 #include <ast/type.h>
 #include "api_internal.h"
+#include "blob_cache.h"
+#include "mipmap_generator.h"
+#include "transient_resource_cache.h"
 
 #ifdef __APPLE__
 #include <TargetConditionals.h>
@@ -42,23 +53,13 @@
 namespace Toucan {
 
 bool exitOnAbort;
+void (*generateShader)(Method* method) = nullptr;
 
 namespace {
 
 wgpu::Instance gInstance;
 std::unordered_map<void*, wgpu::Buffer> gMappedBuffers;
 
-uint32_t BytesPerPixel(wgpu::TextureFormat format) {
-  switch (format) {
-    case wgpu::TextureFormat::RGBA8Unorm:
-    case wgpu::TextureFormat::RGBA8Snorm:
-    case wgpu::TextureFormat::RGBA8Uint:
-    case wgpu::TextureFormat::RGBA8Sint:
-    case wgpu::TextureFormat::BGRA8Unorm: return 4;
-    default: assert(!"unknown Format"); return 0;
-  }
-}
-
 wgpu::TextureUsage ToDawnTextureUsage(int qualifiers) {
   wgpu::TextureUsage result = wgpu::TextureUsage::CopySrc | wgpu::TextureUsage::CopyDst;
 
@@ -93,9 +94,48 @@ void UnmapBuffer(void* This) {
 
 }  // namespace
 
+uint32_t BytesPerPixel(wgpu::TextureFormat format) {
+  switch (format) {
+    case wgpu::TextureFormat::RGBA8Unorm:
+    case wgpu::TextureFormat::RGBA8Snorm:
+    case wgpu::TextureFormat::RGBA8Uint:
+    case wgpu::TextureFormat::RGBA8Sint:
+    case wgpu::TextureFormat::BGRA8Unorm:
+    case wgpu::TextureFormat::RG16Float:
+    case wgpu::TextureFormat::R32Float:
+    case wgpu::TextureFormat::Depth24Plus: return 4;
+    case wgpu::TextureFormat::R16Float: return 2;
+    case wgpu::TextureFormat::RGBA16Float:
+    case wgpu::TextureFormat::RG32Float: return 8;
+    case wgpu::TextureFormat::RGBA32Float: return 16;
+    default: assert(!"unknown Format"); return 0;
+  }
+}
+
+// Returns a pooled texture to its cache once every Texture and view which uses it is gone.
+static std::shared_ptr<void> MakeLease(std::shared_ptr<TransientResourceCache> cache,
+                                      wgpu::Texture                           texture) {
+  return std::shared_ptr<void>(nullptr,
+                               [cache, texture](void*) { cache->ReleaseTexture(texture); });
+}
+
+static std::shared_ptr<void> MakeLease(std::shared_ptr<TransientResourceCache> cache,
+                                      wgpu::Buffer                            buffer) {
+  return std::shared_ptr<void>(nullptr, [cache, buffer](void*) { cache->ReleaseBuffer(buffer); });
+}
+
+// The leases held by an object which binds pooled resources, or by the commands recorded into
+// an encoder until they are submitted. Leases own a null pointer, so they are ordered by owner.
+using Leases = std::set<std::shared_ptr<void>, std::owner_less<>>;
+
+static void AddLease(Leases* leases, const std::shared_ptr<void>& lease) {
+  if (lease.use_count() > 0) { leases->insert(lease); }
+}
+
 struct TextureView {
-  TextureView(wgpu::TextureView v) : view(v) {}
-  wgpu::TextureView view;
+  TextureView(wgpu::TextureView v, std::shared_ptr<void> l = nullptr) : view(v), lease(l) {}
+  wgpu::TextureView     view;
+  std::shared_ptr<void> lease;
 };
 
 struct SampleableTexture1D : public TextureView {
@@ -115,23 +155,31 @@ struct SampleableTextureCube : public TextureView {
 };
 
 struct Texture {
-  Texture(wgpu::Texture t, wgpu::TextureView v) : texture(t), view(v) {}
-  Texture(int                    qualifiers,
-          Type*                  pixelFormat,
-          wgpu::Device           device,
-          wgpu::TextureDimension dimension,
-          wgpu::Extent3D         size,
-          uint32_t               mipLevelCount) {
+  Texture(wgpu::Device d, wgpu::Texture t, wgpu::TextureView v, std::shared_ptr<void> l = nullptr)
+      : device(d), texture(t), view(v), lease(l) {}
+  Texture(int                                     qualifiers,
+          Type*                                   pixelFormat,
+          wgpu::Device                            device,
+          wgpu::TextureDimension                  dimension,
+          wgpu::Extent3D                          size,
+          uint32_t                                mipLevelCount,
+          std::shared_ptr<TransientResourceCache> cache = nullptr)
+      : device(device) {
     wgpu::TextureDescriptor desc;
     desc.usage = ToDawnTextureUsage(qualifiers);
     desc.size = size;
     desc.mipLevelCount = mipLevelCount;
     desc.format = ToDawnTextureFormat(pixelFormat);
     desc.dimension = dimension;
-    texture = device.CreateTexture(&desc);
+    if (cache) {
+      texture = cache->AcquireTexture(device, desc);
+      lease = MakeLease(cache, texture);
+    } else {
+      texture = device.CreateTexture(&desc);
+    }
     view = texture.CreateView();
   }
-  Texture(Texture* t, wgpu::TextureView view) : Texture(t->texture, view) {}
+  Texture(Texture* t, wgpu::TextureView view) : Texture(t->device, t->texture, view, t->lease) {}
   uint32_t MinBufferWidth() {
     uint32_t bytesPerPixel = BytesPerPixel(texture.GetFormat());
     return (((texture.GetWidth() * bytesPerPixel + 255) >> 8) << 8) / bytesPerPixel;
@@ -159,6 +207,37 @@ struct Texture {
     destInfo.mipLevel = mipLevel;
     encoder.CopyBufferToTexture(&sourceInfo, &destInfo, &extent);
   }
+
+  void CopyToBuffer(wgpu::CommandEncoder encoder,
+                    wgpu::Buffer         dest,
+                    wgpu::Extent3D       extent,
+                    wgpu::Origin3D       origin,
+                    uint32_t             mipLevel) {
+    wgpu::TexelCopyTextureInfo sourceInfo;
+    sourceInfo.texture = texture;
+    sourceInfo.origin = origin;
+    sourceInfo.mipLevel = mipLevel;
+    wgpu::TexelCopyBufferInfo destInfo;
+    destInfo.buffer = dest;
+    destInfo.layout.bytesPerRow = MinBufferWidth() * BytesPerPixel(texture.GetFormat());
+    destInfo.layout.rowsPerImage = texture.GetHeight();
+    encoder.CopyTextureToBuffer(&sourceInfo, &destInfo, &extent);
+  }
+
+  // Writes tightly-packed texels straight from host memory. Unlike CopyFromBuffer, rows
+  // need no padding, and no intermediate buffer is created.
+  void Write(Array* data, wgpu::Extent3D extent, wgpu::Origin3D origin, uint32_t mipLevel) {
+    uint32_t                    bytesPerPixel = BytesPerPixel(texture.GetFormat());
+    wgpu::TexelCopyBufferLayout layout;
+    layout.bytesPerRow = extent.width * bytesPerPixel;
+    layout.rowsPerImage = extent.height;
+    wgpu::TexelCopyTextureInfo destInfo;
+    destInfo.texture = texture;
+    destInfo.origin = origin;
+    destInfo.mipLevel = mipLevel;
+    size_t dataSize = static_cast<size_t>(data->length) * bytesPerPixel;
+    device.GetQueue().WriteTexture(&destInfo, data->ptr, dataSize, &layout, &extent);
+  }
   virtual wgpu::TextureViewDimension GetViewDimension() const = 0;
   wgpu::TextureView CreateView(
       uint32_t                   baseMipLevel = 0,
@@ -181,8 +260,10 @@ struct Texture {
   wgpu::TextureView Create2DView(uint32_t baseMipLevel = 0, uint32_t baseArrayLayer = 0) {
     return CreateView(baseMipLevel, 1, baseArrayLayer, 1, wgpu::TextureViewDimension::e2D);
   }
-  wgpu::Texture       texture;
-  wgpu::TextureView   view;
+  wgpu::Device          device;
+  wgpu::Texture         texture;
+  wgpu::TextureView     view;
+  std::shared_ptr<void> lease;  // Set if the texture came from a TransientPool.
 };
 
 struct Texture1D : public Texture {
@@ -221,15 +302,36 @@ struct Sampler {
   wgpu::Sampler sampler;
 };
 
+// The outcome of a MapAsync(). Its callback may run after the Buffer or MapRequest that
+// started it has been destroyed, so the result is shared.
+struct MapResult {
+  wgpu::MapAsyncStatus status = wgpu::MapAsyncStatus::Error;
+  bool                 done = false;
+};
+
+struct MapRequest {
+  MapRequest(std::shared_ptr<MapResult> r, wgpu::Future f) : result(r), future(f) {}
+  std::shared_ptr<MapResult> result;
+  wgpu::Future               future;
+};
+
 struct Buffer {
   Buffer(wgpu::Device d, wgpu::Buffer b, int l, int s, Type* t)
       : device(d), buffer(b), length(l), sizeInBytes(s), type(t) {}
-  wgpu::Device device;
-  wgpu::Buffer buffer;
-  int          length;
-  int          sizeInBytes;
-  Type*        type;
-  Object       mappedObject = {nullptr, nullptr};
+  wgpu::Device               device;
+  wgpu::Buffer               buffer;
+  int                        length;
+  int                        sizeInBytes;
+  Type*                      type;
+  Object                     mappedObject = {nullptr, nullptr};
+  std::shared_ptr<MapResult> pendingMap;
+  wgpu::Future               pendingMapFuture = {};
+  uint32_t                   dynamicStride = 0;  // non-zero for dynamic buffers
+  std::shared_ptr<void>      lease;              // set if the buffer came from a TransientPool
+};
+
+struct PipelineConstants {
+  std::vector<std::pair<std::string, double>> values;
 };
 
 struct RenderPipeline {
@@ -261,6 +363,12 @@ wgpu::TextureFormat ToDawnTextureFormat(Type* format) {
     return wgpu::TextureFormat::RG16Float;
   } else if (classType->GetName() == "R16float") {
     return wgpu::TextureFormat::R16Float;
+  } else if (classType->GetName() == "RGBA32float") {
+    return wgpu::TextureFormat::RGBA32Float;
+  } else if (classType->GetName() == "RG32float") {
+    return wgpu::TextureFormat::RG32Float;
+  } else if (classType->GetName() == "R32float") {
+    return wgpu::TextureFormat::R32Float;
   } else {
     assert(!"unknown Format");
     return wgpu::TextureFormat::RGBA8Unorm;
@@ -300,6 +408,11 @@ static wgpu::VertexFormat toDawnVertexFormat(Type* type) {
         case 3: return wgpu::VertexFormat::Float32x3;
         case 4: return wgpu::VertexFormat::Float32x4;
       }
+    } else if (v->GetElementType()->IsHalf()) {
+      switch (v->GetNumElements()) {
+        case 2: return wgpu::VertexFormat::Float16x2;
+        case 4: return wgpu::VertexFormat::Float16x4;
+      }
     } else if (v->GetElementType()->IsUInt()) {
       switch (v->GetNumElements()) {
         case 2: return wgpu::VertexFormat::Uint32x2;
@@ -318,6 +431,24 @@ static wgpu::VertexFormat toDawnVertexFormat(Type* type) {
   return wgpu::VertexFormat::Uint8x2;
 }
 
+static wgpu::VertexFormat toDawnPackedVertexFormat(ClassType* format) {
+  if (format->GetName() == "Unorm8x4") {
+    return wgpu::VertexFormat::Unorm8x4;
+  } else if (format->GetName() == "Snorm8x4") {
+    return wgpu::VertexFormat::Snorm8x4;
+  } else if (format->GetName() == "Unorm16x4") {
+    return wgpu::VertexFormat::Unorm16x4;
+  } else if (format->GetName() == "Snorm16x4") {
+    return wgpu::VertexFormat::Snorm16x4;
+  } else if (format->GetName() == "Float16x4") {
+    return wgpu::VertexFormat::Float16x4;
+  } else if (format->GetName() == "Unorm10_10_10_2") {
+    return wgpu::VertexFormat::Unorm10_10_10_2;
+  }
+  assert(!"unknown vertex format");
+  return wgpu::VertexFormat::Unorm8x4;
+}
+
 static wgpu::IndexFormat toDawnIndexFormat(Type* type) {
   if (type->IsUInt()) {
     return wgpu::IndexFormat::Uint32;
@@ -409,6 +540,10 @@ static wgpu::BufferUsage toDawnBufferUsage(int qualifiers) {
     result |= wgpu::BufferUsage::Vertex;
     gpu = true;
   }
+  if (qualifiers & Type::Qualifier::Indirect) {
+    result |= wgpu::BufferUsage::Indirect;
+    gpu = true;
+  }
   if (qualifiers & Type::Qualifier::Uniform) {
     result |= wgpu::BufferUsage::Uniform;
     gpu = true;
@@ -459,6 +594,7 @@ static wgpu::FrontFace toDawnFrontFace(FrontFace frontFace) {
 }
 
 wgpu::VertexBufferLayout toDawnVertexBufferLayout(Type*                               vertexInput,
+                                                  wgpu::VertexStepMode                stepMode,
                                                   std::vector<wgpu::VertexAttribute>* vaDescs) {
   size_t start = vaDescs->size();
   if (vertexInput->IsClass()) {
@@ -480,7 +616,7 @@ wgpu::VertexBufferLayout toDawnVertexBufferLayout(Type*
   }
   wgpu::VertexBufferLayout input;
   input.arrayStride = vertexInput->GetSizeInBytes();
-  input.stepMode = wgpu::VertexStepMode::Vertex;
+  input.stepMode = stepMode;
   input.attributeCount = vaDescs->size() - start;
   // Cast the start offset to pointer; this will be added to the vaDesc pointer
   // in FinalizeVertexLayouts. This is necessary to accommodate reallocation
@@ -489,6 +625,25 @@ wgpu::VertexBufferLayout toDawnVertexBufferLayout(Type*
   return input;
 }
 
+// A packed vertex buffer holds a single attribute of the format's host type.
+wgpu::VertexBufferLayout toDawnPackedVertexBufferLayout(ClassType*                          format,
+                                                        wgpu::VertexStepMode                stepMode,
+                                                        std::vector<wgpu::VertexAttribute>* vaDescs) {
+  size_t                start = vaDescs->size();
+  wgpu::VertexAttribute vaDesc;
+  vaDesc.shaderLocation = vaDescs->size();
+  vaDesc.offset = 0;
+  vaDesc.format = toDawnPackedVertexFormat(format);
+  vaDescs->push_back(vaDesc);
+  wgpu::VertexBufferLayout input;
+  input.arrayStride = format->FindType("HostType")->GetSizeInBytes();
+  input.stepMode = stepMode;
+  input.attributeCount = 1;
+  // As above, this offset is converted to a pointer in FinalizeVertexLayouts.
+  input.attributes = reinterpret_cast<wgpu::VertexAttribute*>(start);
+  return input;
+}
+
 wgpu::BufferBindingType toDawnBufferBindingType(int qualifiers) {
   if (qualifiers & Type::Qualifier::Uniform) { return wgpu::BufferBindingType::Uniform; }
   if (qualifiers & Type::Qualifier::Storage) {
@@ -509,6 +664,27 @@ wgpu::BufferBindingType toDawnBufferBindingType(int qualifiers) {
 // FIXME: store this in Device.
 std::unordered_map<Type*, wgpu::BindGroupLayout> bindGroupLayoutCache;
 
+// The distance between elements of a dynamic buffer. Dynamic offsets must be multiples of
+// minUniformBufferOffsetAlignment and minStorageBufferOffsetAlignment, which are at most 256.
+static uint32_t DynamicStride(Type* type) {
+  constexpr uint32_t kDynamicOffsetAlignment = 256;
+  uint32_t           size = type->GetSizeInBytes();
+  return (size + kDynamicOffsetAlignment - 1) / kDynamicOffsetAlignment * kDynamicOffsetAlignment;
+}
+
+// Appends the stride of each dynamic buffer in a bind group class, in binding order.
+static void GetDynamicStrides(ClassType* classType, std::vector<uint32_t>* strides) {
+  if (classType->GetParent()) { GetDynamicStrides(classType->GetParent(), strides); }
+  for (const auto& field : classType->GetFields()) {
+    assert(field->type->IsPtr());
+    int   qualifiers;
+    Type* type = static_cast<PtrType*>(field->type)->GetBaseType()->GetUnqualifiedType(&qualifiers);
+    if (!(qualifiers & Type::Qualifier::Dynamic)) { continue; }
+    assert(type->IsClass());
+    strides->push_back(DynamicStride(static_cast<ClassType*>(type)->GetTemplateArgs()[0]));
+  }
+}
+
 static wgpu::BindGroupLayoutEntry CreateBindGroupLayoutEntry(uint32_t binding,
                                                              Type*    type,
                                                              int      qualifiers) {
@@ -532,6 +708,7 @@ static wgpu::BindGroupLayoutEntry CreateBindGroupLayoutEntry(uint32_t binding,
   assert(templ != NativeClass::None);
   if (templ == NativeClass::Buffer) {
     entry.buffer.type = toDawnBufferBindingType(qualifiers);
+    entry.buffer.hasDynamicOffset = (qualifiers & Type::Qualifier::Dynamic) != 0;
   } else if (templ == NativeClass::SampleableTexture1D) {
     entry.texture.sampleType = ToDawnTextureSampleType(classType, qualifiers);
     entry.texture.viewDimension = wgpu::TextureViewDimension::e1D;
@@ -586,7 +763,7 @@ static wgpu::BindGroupLayout GetOrCreateBindGroupLayout(Device* device, Type* ty
   return layout;
 }
 
-wgpu::BindGroupEntry CreateBindGroupEntry(Type* type, int binding, void* data) {
+wgpu::BindGroupEntry CreateBindGroupEntry(Type* type, int binding, void* data, Leases* leases) {
   wgpu::BindGroupEntry entry;
   entry.binding = binding;
   entry.buffer = nullptr;
@@ -609,10 +786,13 @@ wgpu::BindGroupEntry CreateBindGroupEntry(Type* type, int binding, void* data) {
       templ == NativeClass::SampleableTextureCube) {
     TextureView* textureView = static_cast<TextureView*>(data);
     entry.textureView = textureView->view;
+    AddLease(leases, textureView->lease);
   } else if (templ == NativeClass::Buffer) {
     Buffer* buffer = static_cast<Buffer*>(data);
     entry.buffer = buffer->buffer;
-    entry.size = buffer->sizeInBytes;
+    AddLease(leases, buffer->lease);
+    // A dynamic buffer binds a single element, selected by the offset given to Set().
+    entry.size = buffer->dynamicStride ? buffer->type->GetSizeInBytes() : buffer->sizeInBytes;
   } else {
     assert("!unknown BindGroup entry type");
   }
@@ -620,8 +800,9 @@ wgpu::BindGroupEntry CreateBindGroupEntry(Type* type, int binding, void* data) {
 }
 
 struct BindGroup {
-  BindGroup(wgpu::BindGroup b) : bindGroup(b) {}
+  BindGroup(wgpu::BindGroup b, Leases l) : bindGroup(b), leases(std::move(l)) {}
   wgpu::BindGroup bindGroup;
+  Leases          leases;
 };
 
 struct BindGroupLayout {
@@ -630,40 +811,181 @@ struct BindGroupLayout {
 };
 
 struct VertexInput {
-  VertexInput(const wgpu::Buffer& b) : buffer(b) {}
-  wgpu::Buffer buffer;
+  VertexInput(const wgpu::Buffer& b, std::shared_ptr<void> l) : buffer(b), lease(l) {}
+  wgpu::Buffer          buffer;
+  std::shared_ptr<void> lease;
+};
+
+struct PackedVertexInput : public VertexInput {
+  using VertexInput::VertexInput;
 };
 
 struct ColorOutput {
-  ColorOutput(const wgpu::RenderPassColorAttachment& a) : attachment(a) {}
+  ColorOutput(const wgpu::RenderPassColorAttachment& a, std::shared_ptr<void> l = nullptr)
+      : attachment(a), lease(l) {}
   wgpu::RenderPassColorAttachment attachment;
+  std::shared_ptr<void>           lease;
 };
 
 struct DepthStencilOutput {
-  DepthStencilOutput(const wgpu::RenderPassDepthStencilAttachment& a) : attachment(a) {}
+  DepthStencilOutput(const wgpu::RenderPassDepthStencilAttachment& a,
+                     std::shared_ptr<void>                         l = nullptr)
+      : attachment(a), lease(l) {}
   wgpu::RenderPassDepthStencilAttachment attachment;
+  std::shared_ptr<void>                  lease;
 };
 
+constexpr uint32_t kMaxDynamicOffsets = kMaxDynamicBuffersPerBindGroup;
+
+// The state currently bound on a pass encoder, so that commands which would not change it can
+// be skipped. It is shared by a pass and the passes derived from it, since they record into
+// the same encoder.
+struct PassState {
+  struct BoundGroup {
+    wgpu::BindGroup                          bindGroup;
+    uint32_t                                 offsetCount = 0;
+    std::array<uint32_t, kMaxDynamicOffsets> offsets;
+  };
+  // Counts the command as issued if it changes the state, or skipped if it doesn't.
+  bool Changed(bool changed) {
+    if (changed) {
+      issued++;
+    } else {
+      skipped++;
+    }
+    return changed;
+  }
+  bool SetBindGroup(uint32_t index, wgpu::BindGroup bindGroup, uint32_t offsetCount,
+                    const uint32_t* offsets) {
+    if (index >= bindGroups.size()) { bindGroups.resize(index + 1); }
+    BoundGroup& bound = bindGroups[index];
+    if (!Changed(bound.bindGroup.Get() != bindGroup.Get() || bound.offsetCount != offsetCount ||
+                 !std::equal(offsets, offsets + offsetCount, bound.offsets.begin()))) {
+      return false;
+    }
+    bound.bindGroup = bindGroup;
+    bound.offsetCount = offsetCount;
+    std::copy(offsets, offsets + offsetCount, bound.offsets.begin());
+    return true;
+  }
+  bool SetVertexBuffer(uint32_t index, wgpu::Buffer buffer) {
+    if (index >= vertexBuffers.size()) { vertexBuffers.resize(index + 1); }
+    if (!Changed(vertexBuffers[index].Get() != buffer.Get())) { return false; }
+    vertexBuffers[index] = buffer;
+    return true;
+  }
+  bool SetIndexBuffer(wgpu::Buffer buffer, wgpu::IndexFormat format) {
+    if (!Changed(indexBuffer.Get() != buffer.Get() || indexFormat != format)) { return false; }
+    indexBuffer = buffer;
+    indexFormat = format;
+    return true;
+  }
+  template <typename P>
+  bool SetPipeline(P p) {
+    if (!Changed(pipeline != static_cast<const void*>(p.Get()))) { return false; }
+    pipeline = p.Get();
+    return true;
+  }
+
+  // Executing render bundles resets all of the pass's state.
+  void Reset() {
+    bindGroups.clear();
+    vertexBuffers.clear();
+    indexBuffer = nullptr;
+    pipeline = nullptr;
+  }
+
+  std::vector<BoundGroup>   bindGroups;
+  std::vector<wgpu::Buffer> vertexBuffers;
+  wgpu::Buffer              indexBuffer;
+  wgpu::IndexFormat         indexFormat = wgpu::IndexFormat::Undefined;
+  const void*               pipeline = nullptr;
+  uint32_t                  issued = 0;
+  uint32_t                  skipped = 0;
+};
+
+struct BindingPlan;
+
+// Passes add the leases of the resources they use to those of their command encoder.
 struct RenderPass {
-  RenderPass(wgpu::RenderPassEncoder e, Type* t) : encoder(e), type(t) {}
-  wgpu::RenderPassEncoder encoder;
-  Type*                   type;
+  RenderPass(wgpu::RenderPassEncoder            e,
+             Type*                              t,
+             std::shared_ptr<BindingPlanMap>    m,
+             std::shared_ptr<const BindingPlan> p,
+             std::shared_ptr<Leases>            l,
+             std::shared_ptr<PassState>         s = std::make_shared<PassState>())
+      : encoder(e), type(t), bindingPlans(m), plan(p), leases(l), state(s) {}
+  wgpu::RenderPassEncoder            encoder;
+  Type*                              type;
+  std::shared_ptr<BindingPlanMap>    bindingPlans;
+  std::shared_ptr<const BindingPlan> plan;
+  std::shared_ptr<Leases>            leases;
+  std::shared_ptr<PassState>         state;
 };
 
 struct ComputePass {
-  ComputePass(wgpu::ComputePassEncoder e, Type* t) : encoder(e), type(t) {}
-  wgpu::ComputePassEncoder encoder;
-  Type*                    type;
+  ComputePass(wgpu::ComputePassEncoder           e,
+              Type*                              t,
+              std::shared_ptr<BindingPlanMap>    m,
+              std::shared_ptr<const BindingPlan> p,
+              std::shared_ptr<Leases>            l,
+              std::shared_ptr<PassState>         s = std::make_shared<PassState>())
+      : encoder(e), type(t), bindingPlans(m), plan(p), leases(l), state(s) {}
+  wgpu::ComputePassEncoder           encoder;
+  Type*                              type;
+  std::shared_ptr<BindingPlanMap>    bindingPlans;
+  std::shared_ptr<const BindingPlan> plan;
+  std::shared_ptr<Leases>            leases;
+  std::shared_ptr<PassState>         state;
 };
 
+// Flags which are set when the commands recorded into an encoder are submitted, passed from
+// the encoder to the command buffer it finishes.
+using SubmitFlags = std::vector<std::shared_ptr<bool>>;
+
 struct CommandEncoder {
-  CommandEncoder(wgpu::CommandEncoder e) : encoder(e) {}
-  wgpu::CommandEncoder encoder;
+  CommandEncoder(wgpu::CommandEncoder                  e,
+                 std::shared_ptr<BindingPlanMap>      m,
+                 std::shared_ptr<MipmapPipelineCache> p)
+      : encoder(e), bindingPlans(m), mipmapPipelines(p) {}
+  wgpu::CommandEncoder                 encoder;
+  std::shared_ptr<BindingPlanMap>      bindingPlans;
+  std::shared_ptr<MipmapPipelineCache> mipmapPipelines;
+  SubmitFlags                          submitFlags;
+  std::shared_ptr<Leases>              leases = std::make_shared<Leases>();
 };
 
 struct CommandBuffer {
-  CommandBuffer(wgpu::CommandBuffer cb) : commandBuffer(cb) {}
+  CommandBuffer(wgpu::CommandBuffer cb, SubmitFlags f, Leases l)
+      : commandBuffer(cb), submitFlags(f), leases(std::move(l)) {}
   wgpu::CommandBuffer commandBuffer;
+  SubmitFlags         submitFlags;
+  Leases              leases;
+};
+
+// Once submitted, later uses of a pooled resource are ordered after these commands, and
+// destroying it waits for them, so the command buffer's leases can be released.
+static void MarkSubmitted(CommandBuffer* commandBuffer) {
+  for (auto& flag : commandBuffer->submitFlags) {
+    *flag = true;
+  }
+  commandBuffer->submitFlags.clear();
+  commandBuffer->leases.clear();
+}
+
+struct RenderBundleEncoder {
+  RenderBundleEncoder(wgpu::RenderBundleEncoder e, std::shared_ptr<const BindingPlan> p)
+      : encoder(e), plan(p) {}
+  wgpu::RenderBundleEncoder          encoder;
+  std::shared_ptr<const BindingPlan> plan;
+  PassState                          state;
+  Leases                             leases;
+};
+
+struct RenderBundle {
+  RenderBundle(wgpu::RenderBundle b, Leases l) : bundle(b), leases(std::move(l)) {}
+  wgpu::RenderBundle bundle;
+  Leases             leases;
 };
 
 struct Queue {
@@ -673,11 +995,64 @@ struct Queue {
 
 Queue* Device_GetQueue(Device* device) { return new Queue(device->device.GetQueue()); }
 
+static wgpu::FeatureName ToDawnFeatureName(Feature feature) {
+  switch (feature) {
+    case Feature::Subgroups: return wgpu::FeatureName::Subgroups;
+    case Feature::ShaderF16: return wgpu::FeatureName::ShaderF16;
+  }
+  assert(!"unknown feature");
+  return wgpu::FeatureName::Subgroups;
+}
+
+bool Device_HasFeature(Device* This, Feature feature) {
+  return This->device.HasFeature(ToDawnFeatureName(feature));
+}
+
+uint32_t Device_GetPipelineCacheHits(Device* This) { return This->cacheHits; }
+
+uint32_t Device_GetPipelineCacheMisses(Device* This) { return This->cacheMisses; }
+
+void Device_ProcessEvents(Device* This) { gInstance.ProcessEvents(); }
+
 void Device_Destroy(Device* This) { delete This; }
 
+// Textures and buffers created from the pool share ownership of its cache, so they may outlive
+// the TransientPool itself.
+struct TransientPool {
+  TransientPool(wgpu::Device d, std::shared_ptr<TransientResourceCache> c) : device(d), cache(c) {}
+  wgpu::Device                            device;
+  std::shared_ptr<TransientResourceCache> cache;
+};
+
+TransientPool* TransientPool_TransientPool(Device*  device,
+                                           uint32_t maxCachedBytes,
+                                           uint32_t maxIdleFrames) {
+  return new TransientPool(device->device,
+                           std::make_shared<TransientResourceCache>(maxCachedBytes, maxIdleFrames));
+}
+
+void TransientPool_Destroy(TransientPool* This) { delete This; }
+
+void TransientPool_NextFrame(TransientPool* This) { This->cache->NextFrame(); }
+
+uint32_t TransientPool_GetCachedBytes(TransientPool* This) { return This->cache->GetCachedBytes(); }
+
 void Queue_Destroy(Queue* This) { delete This; }
 
 wgpu::ShaderModule createShaderModule(Device* device, Method* m) {
+  if (m->spirv.empty() && m->wgsl.empty() && generateShader) { generateShader(m); }
+  if ((m->shaderFeatures & Method::ShaderFeature::Subgroups) &&
+      !device->device.HasFeature(wgpu::FeatureName::Subgroups)) {
+    fprintf(stderr, "%s.%s() uses subgroup operations, which are not supported by this device\n",
+            m->classType->GetName().c_str(), m->name.c_str());
+    return nullptr;
+  }
+  if ((m->shaderFeatures & Method::ShaderFeature::ShaderF16) &&
+      !device->device.HasFeature(wgpu::FeatureName::ShaderF16)) {
+    fprintf(stderr, "%s.%s() uses half types, which are not supported by this device\n",
+            m->classType->GetName().c_str(), m->name.c_str());
+    return nullptr;
+  }
   wgpu::ShaderModuleDescriptor desc;
 #ifdef __EMSCRIPTEN__
   wgpu::ShaderSourceWGSL wgslDesc;
@@ -723,12 +1098,21 @@ static void ExtractPipelineLayout(ClassType* classType, Device* device, wgpu::Bl
     assert(unqualifiedType->IsClass());
 
     ClassType* classType = static_cast<ClassType*>(unqualifiedType);
-    if (classType->GetTemplate() == NativeClass::VertexInput) {
+    if (classType->GetTemplate() == NativeClass::VertexInput ||
+        classType->GetTemplate() == NativeClass::PackedVertexInput) {
       const auto& templateArgs = classType->GetTemplateArgs();
       assert(templateArgs.size() == 1);
       Type* elementType = templateArgs[0];
-      auto layout = toDawnVertexBufferLayout(elementType, &out->vertexAttributes);
-      out->vertexBufferLayouts.push_back(layout);
+      auto  stepMode = qualifiers & Type::Qualifier::Instance ? wgpu::VertexStepMode::Instance
+                                                              : wgpu::VertexStepMode::Vertex;
+      if (classType->GetTemplate() == NativeClass::PackedVertexInput) {
+        assert(elementType->IsClass());
+        out->vertexBufferLayouts.push_back(toDawnPackedVertexBufferLayout(
+            static_cast<ClassType*>(elementType), stepMode, &out->vertexAttributes));
+      } else {
+        out->vertexBufferLayouts.push_back(
+            toDawnVertexBufferLayout(elementType, stepMode, &out->vertexAttributes));
+      }
     } else if (classType->GetTemplate() == NativeClass::ColorOutput) {
       wgpu::ColorTargetState colorTargetState;
       const auto&            templateArgs = classType->GetTemplateArgs();
@@ -759,91 +1143,259 @@ static void ExtractPipelineLayout(ClassType* classType, Device* device, wgpu::Bl
   }
 }
 
-struct PipelineData {
-  std::vector<wgpu::BindGroup>                 bindGroups;
-  std::vector<wgpu::RenderPassColorAttachment> colorAttachments;
-  wgpu::RenderPassDepthStencilAttachment       depthStencilAttachment;
-  std::vector<wgpu::Buffer>                    vertexBuffers;
-  wgpu::Buffer                                 indexBuffer;
-  wgpu::IndexFormat                            indexFormat;
-
-  void Set(wgpu::RenderPassEncoder encoder) {
-    for (int i = 0; i < bindGroups.size(); i++) {
-      if (bindGroups[i]) { encoder.SetBindGroup(i, bindGroups[i]); }
-    }
-    for (int i = 0; i < vertexBuffers.size(); i++) {
-      if (vertexBuffers[i]) { encoder.SetVertexBuffer(i, vertexBuffers[i]); }
-    }
-    if (indexBuffer) { encoder.SetIndexBuffer(indexBuffer, indexFormat); }
-  }
-
-  void Set(wgpu::ComputePassEncoder encoder) {
-    for (int i = 0; i < bindGroups.size(); i++) {
-      if (bindGroups[i]) { encoder.SetBindGroup(i, bindGroups[i]); }
-    }
-  }
+// A flattened description of the fields of a RenderPass or ComputePass data class, built once
+// per class, so that Set() is a single loop over the fields with no reflection or allocation.
+struct BindingPlan {
+  enum class Kind { BindGroup, VertexBuffer, IndexBuffer, ColorOutput, DepthStencilOutput };
+  struct Entry {
+    uint32_t          offset;           // of the field's Object within the data
+    Kind              kind;
+    uint32_t          index;            // bind group or vertex buffer slot
+    uint32_t          firstStride = 0;  // dynamic buffer strides, for bind groups
+    uint32_t          strideCount = 0;
+    wgpu::IndexFormat indexFormat = wgpu::IndexFormat::Undefined;
+  };
+  std::vector<Entry>    entries;
+  std::vector<uint32_t> strides;
+  uint32_t              bindGroupCount = 0;
+  uint32_t              vertexBufferCount = 0;
 };
 
-static void ExtractPipelineData(Type* type, void* data, PipelineData* out) {
-  assert(type->IsClass());
-  auto classType = static_cast<ClassType*>(type);
-  if (classType->GetParent()) { ExtractPipelineData(classType->GetParent(), data, out); }
+static void BuildBindingPlan(ClassType* classType, BindingPlan* plan) {
+  if (classType->GetParent()) { BuildBindingPlan(classType->GetParent(), plan); }
   for (const auto& field : classType->GetFields()) {
     Type* fieldType = field->type;
     assert(fieldType->IsPtr());
     fieldType = static_cast<PtrType*>(fieldType)->GetBaseType();
     int qualifiers;
     fieldType = fieldType->GetUnqualifiedType(&qualifiers);
-    Object* object = reinterpret_cast<Object*>((uint8_t*)data + field->offset);
-    void* ptr = object->ptr;
     assert(fieldType->IsClass());
-    auto classType = static_cast<ClassType*>(fieldType);
-    if (classType->GetTemplate() == NativeClass::VertexInput && ptr) {
-      out->vertexBuffers.push_back(static_cast<VertexInput*>(ptr)->buffer);
-    } else if (classType->GetTemplate() == NativeClass::ColorOutput && ptr) {
-      out->colorAttachments.push_back(static_cast<ColorOutput*>(ptr)->attachment);
-    } else if (classType->GetTemplate() == NativeClass::DepthStencilOutput && ptr) {
-      out->depthStencilAttachment = static_cast<DepthStencilOutput*>(ptr)->attachment;
-    } else if (classType->GetTemplate() == NativeClass::Buffer &&
-               qualifiers == Type::Qualifier::Index) {
-      if (auto buffer = static_cast<Buffer*>(ptr)) {
-        out->indexBuffer = buffer ? buffer->buffer : nullptr;
-        out->indexFormat =
-            toDawnIndexFormat(static_cast<ArrayType*>(buffer->type)->GetElementType());
+    auto               fieldClass = static_cast<ClassType*>(fieldType);
+    BindingPlan::Entry entry;
+    entry.offset = field->offset;
+    auto templ = fieldClass->GetTemplate();
+    if (templ == NativeClass::VertexInput || templ == NativeClass::PackedVertexInput) {
+      entry.kind = BindingPlan::Kind::VertexBuffer;
+      entry.index = plan->vertexBufferCount++;
+    } else if (templ == NativeClass::ColorOutput) {
+      entry.kind = BindingPlan::Kind::ColorOutput;
+    } else if (templ == NativeClass::DepthStencilOutput) {
+      entry.kind = BindingPlan::Kind::DepthStencilOutput;
+    } else if (templ == NativeClass::Buffer && qualifiers == Type::Qualifier::Index) {
+      entry.kind = BindingPlan::Kind::IndexBuffer;
+      auto arrayType = static_cast<ArrayType*>(fieldClass->GetTemplateArgs()[0]);
+      entry.indexFormat = toDawnIndexFormat(arrayType->GetElementType());
+    } else if (templ == NativeClass::BindGroup) {
+      entry.kind = BindingPlan::Kind::BindGroup;
+      entry.index = plan->bindGroupCount++;
+      entry.firstStride = plan->strides.size();
+      GetDynamicStrides(static_cast<ClassType*>(fieldClass->GetTemplateArgs()[0]),
+                        &plan->strides);
+      entry.strideCount = plan->strides.size() - entry.firstStride;
+      // The API validator rejects these, but check here too since the offsets are staged in
+      // fixed-size arrays.
+      if (entry.strideCount > kMaxDynamicOffsets) {
+        fprintf(stderr, "%s has %u dynamic buffers, but at most %u are supported\n",
+                fieldClass->ToString().c_str(), entry.strideCount, kMaxDynamicOffsets);
+        continue;
       }
-    } else if (classType->GetTemplate() == NativeClass::BindGroup) {
-      out->bindGroups.push_back(ptr ? static_cast<BindGroup*>(ptr)->bindGroup
-                                           : nullptr);
+    } else {
+      continue;
     }
+    plan->entries.push_back(entry);
   }
 }
 
-RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
-                                              Type*             type,
-                                              Device*           device,
-                                              PrimitiveTopology primitiveTopology,
-                                              FrontFace         frontFace,
-                                              CullMode          cullMode,
-                                              DepthStencilState*depthStencil,
-                                              BlendState*       blendState) {
-  if (!type->IsClass()) { return nullptr; }
-  ClassType*         classType = static_cast<ClassType*>(type);
-  wgpu::ShaderModule vertexShader, fragmentShader;
-  for (ClassType* c = classType; c != nullptr && (!vertexShader || !fragmentShader);
+static std::shared_ptr<const BindingPlan> GetBindingPlan(BindingPlanMap* plans, Type* type) {
+  auto& plan = (*plans)[type];
+  if (!plan) {
+    assert(type->IsClass());
+    auto newPlan = std::make_shared<BindingPlan>();
+    BuildBindingPlan(static_cast<ClassType*>(type), newPlan.get());
+    plan = newPlan;
+  }
+  return plan;
+}
+
+static void* GetFieldPtr(void* data, const BindingPlan::Entry& entry) {
+  return reinterpret_cast<Object*>(static_cast<uint8_t*>(data) + entry.offset)->ptr;
+}
+
+// Issues the commands for the bind groups, vertex buffers and index buffer in data. The
+// dynamic indices select one element of each dynamic buffer, in field order; missing indices
+// select element 0.
+template <typename E>
+static void ApplyBindingPlan(const BindingPlan& plan,
+                             E                  encoder,
+                             PassState*         state,
+                             Leases*            leases,
+                             void*              data,
+                             const Array*       dynamicIndices) {
+  const uint32_t* indices = dynamicIndices ? static_cast<uint32_t*>(dynamicIndices->ptr) : nullptr;
+  uint32_t        indexCount = dynamicIndices ? dynamicIndices->length : 0;
+  for (const auto& entry : plan.entries) {
+    void* ptr = GetFieldPtr(data, entry);
+    if (!ptr) { continue; }
+    if (entry.kind == BindingPlan::Kind::BindGroup) {
+      uint32_t offsets[kMaxDynamicOffsets];
+      for (uint32_t i = 0; i < entry.strideCount; ++i) {
+        uint32_t j = entry.firstStride + i;
+        offsets[i] = j < indexCount ? indices[j] * plan.strides[j] : 0;
+      }
+      auto bindGroup = static_cast<BindGroup*>(ptr);
+      if (state->SetBindGroup(entry.index, bindGroup->bindGroup, entry.strideCount, offsets)) {
+        encoder.SetBindGroup(entry.index, bindGroup->bindGroup, entry.strideCount, offsets);
+        leases->insert(bindGroup->leases.begin(), bindGroup->leases.end());
+      }
+    }
+    if constexpr (!std::is_same_v<E, wgpu::ComputePassEncoder>) {
+      if (entry.kind == BindingPlan::Kind::VertexBuffer) {
+        auto vertexInput = static_cast<VertexInput*>(ptr);
+        if (state->SetVertexBuffer(entry.index, vertexInput->buffer)) {
+          encoder.SetVertexBuffer(entry.index, vertexInput->buffer);
+          AddLease(leases, vertexInput->lease);
+        }
+      } else if (entry.kind == BindingPlan::Kind::IndexBuffer) {
+        auto buffer = static_cast<Buffer*>(ptr);
+        if (state->SetIndexBuffer(buffer->buffer, entry.indexFormat)) {
+          encoder.SetIndexBuffer(buffer->buffer, entry.indexFormat);
+          AddLease(leases, buffer->lease);
+        }
+      }
+    }
+  }
+}
+
+// Pipeline-overridable constants for a single shader stage. Dawn identifies
+// each one by its SpecId, which is its index in the method's specConstants.
+struct StageConstants {
+  std::vector<std::string>         keys;
+  std::vector<wgpu::ConstantEntry> entries;
+};
+
+static void ExtractStageConstants(const PipelineConstants* constants,
+                                  const Method*            method,
+                                  StageConstants*          out) {
+  if (!constants) { return; }
+  const auto& names = method->specConstants;
+  std::vector<double> values;
+  for (const auto& [name, value] : constants->values) {
+    auto it = std::find(names.begin(), names.end(), name);
+    if (it == names.end()) { continue; }
+    out->keys.push_back(std::to_string(it - names.begin()));
+    values.push_back(value);
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    wgpu::ConstantEntry entry;
+    entry.key = out->keys[i].c_str();
+    entry.value = values[i];
+    out->entries.push_back(entry);
+  }
+}
+
+PipelineConstants* PipelineConstants_PipelineConstants() { return new PipelineConstants(); }
+
+void PipelineConstants_Destroy(PipelineConstants* This) { delete This; }
+
+void PipelineConstants_Set(PipelineConstants* This, Array* name, double value) {
+  std::string key(static_cast<const char*>(name->ptr), name->length);
+  for (auto& entry : This->values) {
+    if (entry.first == key) {
+      entry.second = value;
+      return;
+    }
+  }
+  This->values.push_back({key, value});
+}
+
+static wgpu::ShaderModule GetOrCreateShaderModule(Device* device, Method* method) {
+  auto it = device->shaderModules.find(method);
+  if (it != device->shaderModules.end()) {
+    device->cacheHits++;
+    return it->second;
+  }
+  device->cacheMisses++;
+  wgpu::ShaderModule shaderModule = createShaderModule(device, method);
+  if (shaderModule) { device->shaderModules[method] = shaderModule; }
+  return shaderModule;
+}
+
+static wgpu::PipelineLayout GetOrCreatePipelineLayout(Device*               device,
+                                                      Type*                 type,
+                                                      const PipelineLayout& pipelineLayout) {
+  auto it = device->pipelineLayouts.find(type);
+  if (it != device->pipelineLayouts.end()) {
+    device->cacheHits++;
+    return it->second;
+  }
+  device->cacheMisses++;
+  wgpu::PipelineLayoutDescriptor desc;
+  desc.bindGroupLayoutCount = pipelineLayout.bindGroupLayouts.size();
+  desc.bindGroupLayouts = pipelineLayout.bindGroupLayouts.data();
+  return device->pipelineLayouts[type] = device->device.CreatePipelineLayout(&desc);
+}
+
+template <typename T> static void AppendToKey(std::string* key, const T& value) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void AppendToKey(std::string* key, const PipelineConstants* constants) {
+  if (!constants) { return; }
+  for (const auto& [name, value] : constants->values) {
+    AppendToKey(key, name.size());
+    key->append(name);
+    AppendToKey(key, value);
+  }
+}
+
+static std::string RenderPipelineKey(Type*              type,
+                                     PipelineConstants* constants,
+                                     PrimitiveTopology  primitiveTopology,
+                                     FrontFace          frontFace,
+                                     CullMode           cullMode,
+                                     BlendState*        blendState) {
+  std::string key;
+  AppendToKey(&key, type);
+  AppendToKey(&key, primitiveTopology);
+  AppendToKey(&key, frontFace);
+  AppendToKey(&key, cullMode);
+  for (const BlendComponent& c : {blendState->color, blendState->alpha}) {
+    AppendToKey(&key, c.operation);
+    AppendToKey(&key, c.srcFactor);
+    AppendToKey(&key, c.dstFactor);
+  }
+  AppendToKey(&key, constants);
+  return key;
+}
+
+// Builds the descriptor for a render pipeline and passes it to create(), which is shared by
+// the blocking and asynchronous constructors. Returns false if a shader module can't be
+// created.
+template <typename CreateFn>
+static bool BuildRenderPipeline(ClassType*         classType,
+                                Device*            device,
+                                PipelineConstants* constants,
+                                PrimitiveTopology  primitiveTopology,
+                                FrontFace          frontFace,
+                                CullMode           cullMode,
+                                BlendState*        blendState,
+                                CreateFn           create) {
+  Method*    vertexMethod = nullptr;
+  Method*    fragmentMethod = nullptr;
+  for (ClassType* c = classType; c != nullptr && (!vertexMethod || !fragmentMethod);
        c = c->GetParent()) {
     for (auto& method : c->GetMethods()) {
       if (method->modifiers & Method::Modifier::Vertex) {
-        if (!vertexShader) {
-          vertexShader = createShaderModule(device, method.get());
-        }
+        if (!vertexMethod) { vertexMethod = method.get(); }
       } else if (method->modifiers & Method::Modifier::Fragment) {
-        if (!fragmentShader) {
-          fragmentShader = createShaderModule(device, method.get());
-        }
+        if (!fragmentMethod) { fragmentMethod = method.get(); }
       }
     }
   }
-  assert(vertexShader && fragmentShader);
+  assert(vertexMethod && fragmentMethod);
+  wgpu::ShaderModule vertexShader = GetOrCreateShaderModule(device, vertexMethod);
+  wgpu::ShaderModule fragmentShader = GetOrCreateShaderModule(device, fragmentMethod);
+  if (!vertexShader || !fragmentShader) { return false; }
   PipelineLayout pipelineLayout;
   auto dawnBlendState = toDawnBlendState(*blendState);
   ExtractPipelineLayout(classType, device, &dawnBlendState, &pipelineLayout);
@@ -852,6 +1404,10 @@ RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
   wgpu::VertexState vertexState;
   vertexState.module = vertexShader;
   vertexState.entryPoint = "main";
+  StageConstants vertexConstants;
+  ExtractStageConstants(constants, vertexMethod, &vertexConstants);
+  vertexState.constantCount = vertexConstants.entries.size();
+  vertexState.constants = vertexConstants.entries.data();
   vertexState.bufferCount = pipelineLayout.vertexBufferLayouts.size();
   vertexState.buffers = pipelineLayout.vertexBufferLayouts.data();
   wgpu::RenderPipelineDescriptor rpDesc;
@@ -864,14 +1420,13 @@ RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
   wgpu::FragmentState fragmentState;
   fragmentState.module = fragmentShader;
   fragmentState.entryPoint = "main";
-  fragmentState.constants = nullptr;
+  StageConstants fragmentConstants;
+  ExtractStageConstants(constants, fragmentMethod, &fragmentConstants);
+  fragmentState.constantCount = fragmentConstants.entries.size();
+  fragmentState.constants = fragmentConstants.entries.data();
   fragmentState.targetCount = pipelineLayout.colorTargets.size();
   fragmentState.targets = pipelineLayout.colorTargets.data();
-  wgpu::PrimitiveState           primitiveState;
-  wgpu::PipelineLayoutDescriptor desc;
-  desc.bindGroupLayoutCount = pipelineLayout.bindGroupLayouts.size();
-  desc.bindGroupLayouts = pipelineLayout.bindGroupLayouts.data();
-  rpDesc.layout = device->device.CreatePipelineLayout(&desc);
+  rpDesc.layout = GetOrCreatePipelineLayout(device, classType, pipelineLayout);
   rpDesc.vertex = vertexState;
   rpDesc.fragment = &fragmentState;
   rpDesc.primitive.topology = toDawnPrimitiveTopology(primitiveTopology);
@@ -883,56 +1438,321 @@ RenderPipeline* RenderPipeline_RenderPipeline(int               qualifiers,
   if (pipelineLayout.depthStencilTarget.format != wgpu::TextureFormat::Undefined) {
     rpDesc.depthStencil = &depthStencilState;
   }
-  return new RenderPipeline(device->device.CreateRenderPipeline(&rpDesc));
+  create(rpDesc);
+  return true;
+}
+
+static RenderPipeline* CreateRenderPipeline(Type*              type,
+                                            Device*            device,
+                                            PipelineConstants* constants,
+                                            PrimitiveTopology  primitiveTopology,
+                                            FrontFace          frontFace,
+                                            CullMode           cullMode,
+                                            DepthStencilState* depthStencil,
+                                            BlendState*        blendState) {
+  if (!type->IsClass()) { return nullptr; }
+  std::string key = RenderPipelineKey(type, constants, primitiveTopology, frontFace, cullMode,
+                                      blendState);
+  auto cached = device->renderPipelines.find(key);
+  if (cached != device->renderPipelines.end()) {
+    device->cacheHits++;
+    return new RenderPipeline(cached->second);
+  }
+  device->cacheMisses++;
+  wgpu::RenderPipeline pipeline;
+  if (!BuildRenderPipeline(static_cast<ClassType*>(type), device, constants, primitiveTopology,
+                           frontFace, cullMode, blendState,
+                           [&](const wgpu::RenderPipelineDescriptor& desc) {
+                             pipeline = device->device.CreateRenderPipeline(&desc);
+                           })) {
+    return nullptr;
+  }
+  device->renderPipelines[key] = pipeline;
+  return new RenderPipeline(pipeline);
+}
+
+RenderPipeline* RenderPipeline_RenderPipeline_Device_PrimitiveTopology_FrontFace_CullMode_DepthStencilState_BlendState(
+    int                qualifiers,
+    Type*              type,
+    Device*            device,
+    PrimitiveTopology  primitiveTopology,
+    FrontFace          frontFace,
+    CullMode           cullMode,
+    DepthStencilState* depthStencil,
+    BlendState*        blendState) {
+  return CreateRenderPipeline(type, device, nullptr, primitiveTopology, frontFace, cullMode,
+                              depthStencil, blendState);
+}
+
+RenderPipeline* RenderPipeline_RenderPipeline_Device_PipelineConstants_PrimitiveTopology_FrontFace_CullMode_DepthStencilState_BlendState(
+    int                qualifiers,
+    Type*              type,
+    Device*            device,
+    PipelineConstants* constants,
+    PrimitiveTopology  primitiveTopology,
+    FrontFace          frontFace,
+    CullMode           cullMode,
+    DepthStencilState* depthStencil,
+    BlendState*        blendState) {
+  return CreateRenderPipeline(type, device, constants, primitiveTopology, frontFace, cullMode,
+                              depthStencil, blendState);
 }
 
 void RenderPipeline_Destroy(RenderPipeline* This) { delete This; }
 
-ComputePipeline* ComputePipeline_ComputePipeline(int     qualifiers,
-                                                 Type*   computeLayout,
-                                                 Device* device) {
-  if (!computeLayout->IsClass()) { return nullptr; }
-  ClassType*         classType = static_cast<ClassType*>(computeLayout);
+// Same as BuildRenderPipeline(), for compute pipelines.
+template <typename CreateFn>
+static bool BuildComputePipeline(ClassType*         classType,
+                                 Device*            device,
+                                 PipelineConstants* constants,
+                                 CreateFn           create) {
   wgpu::ShaderModule computeShader;
+  Method*            computeMethod = nullptr;
   for (auto& method : classType->GetMethods()) {
     if (method->modifiers & Method::Modifier::Compute) {
       if (computeShader) {
         assert(!"more than one compute shader specified");
-        return nullptr;
+        return false;
       }
-      computeShader = createShaderModule(device, method.get());
+      computeMethod = method.get();
+      computeShader = GetOrCreateShaderModule(device, computeMethod);
+      if (!computeShader) { return false; }
     }
   }
   wgpu::ComputeState computeState;
   computeState.module = computeShader;
   computeState.entryPoint = "main";
+  StageConstants computeConstants;
+  if (computeMethod) { ExtractStageConstants(constants, computeMethod, &computeConstants); }
+  computeState.constantCount = computeConstants.entries.size();
+  computeState.constants = computeConstants.entries.data();
   wgpu::ComputePipelineDescriptor cpDesc;
   PipelineLayout                  pipelineLayout;
   ExtractPipelineLayout(classType, device, nullptr, &pipelineLayout);
-  wgpu::PipelineLayoutDescriptor desc;
-  desc.bindGroupLayoutCount = pipelineLayout.bindGroupLayouts.size();
-  desc.bindGroupLayouts = pipelineLayout.bindGroupLayouts.data();
-  cpDesc.layout = device->device.CreatePipelineLayout(&desc);
+  cpDesc.layout = GetOrCreatePipelineLayout(device, classType, pipelineLayout);
   cpDesc.compute = computeState;
-  return new ComputePipeline(device->device.CreateComputePipeline(&cpDesc));
+  create(cpDesc);
+  return true;
+}
+
+static std::string ComputePipelineKey(Type* type, PipelineConstants* constants) {
+  std::string key;
+  AppendToKey(&key, type);
+  AppendToKey(&key, constants);
+  return key;
+}
+
+static ComputePipeline* CreateComputePipeline(Type*              computeLayout,
+                                              Device*            device,
+                                              PipelineConstants* constants) {
+  if (!computeLayout->IsClass()) { return nullptr; }
+  std::string key = ComputePipelineKey(computeLayout, constants);
+  auto cached = device->computePipelines.find(key);
+  if (cached != device->computePipelines.end()) {
+    device->cacheHits++;
+    return new ComputePipeline(cached->second);
+  }
+  device->cacheMisses++;
+  wgpu::ComputePipeline pipeline;
+  if (!BuildComputePipeline(static_cast<ClassType*>(computeLayout), device, constants,
+                            [&](const wgpu::ComputePipelineDescriptor& desc) {
+                              pipeline = device->device.CreateComputePipeline(&desc);
+                            })) {
+    return nullptr;
+  }
+  device->computePipelines[key] = pipeline;
+  return new ComputePipeline(pipeline);
+}
+
+ComputePipeline* ComputePipeline_ComputePipeline_Device(int     qualifiers,
+                                                        Type*   computeLayout,
+                                                        Device* device) {
+  return CreateComputePipeline(computeLayout, device, nullptr);
+}
+
+ComputePipeline* ComputePipeline_ComputePipeline_Device_PipelineConstants(
+    int                qualifiers,
+    Type*              computeLayout,
+    Device*            device,
+    PipelineConstants* constants) {
+  return CreateComputePipeline(computeLayout, device, constants);
 }
 
 void ComputePipeline_Destroy(ComputePipeline* This) { delete This; }
 
+// Pipelines created with CreateRenderPipelineAsync()/CreateComputePipelineAsync(). The
+// callback only runs from within WaitAny(), but it may outlive the handle, so the result is
+// shared with it.
+template <typename P>
+struct AsyncPipeline {
+  struct Result {
+    P    pipeline;
+    bool done = false;
+  };
+  bool IsReady() {
+    if (!result->done) {
+      wgpu::FutureWaitInfo waitInfo = {future};
+      gInstance.WaitAny(1, &waitInfo, 0);
+    }
+    return result->done;
+  }
+  P Wait() {
+    if (!result->done) {
+      wgpu::FutureWaitInfo waitInfo = {future};
+      gInstance.WaitAny(1, &waitInfo, UINT64_MAX);
+    }
+    return result->pipeline;
+  }
+  auto OnCreated() {
+    return [result = result](wgpu::CreatePipelineAsyncStatus status, P pipeline,
+                             wgpu::StringView message) {
+      if (status != wgpu::CreatePipelineAsyncStatus::Success) {
+        fprintf(stderr, "pipeline creation failed: %.*s\n", static_cast<int>(message.length),
+                message.data);
+      }
+      result->pipeline = pipeline;
+      result->done = true;
+    };
+  }
+  std::shared_ptr<Result> result = std::make_shared<Result>();
+  wgpu::Future            future = {};
+};
+
+struct AsyncRenderPipeline : public AsyncPipeline<wgpu::RenderPipeline> {};
+struct AsyncComputePipeline : public AsyncPipeline<wgpu::ComputePipeline> {};
+
+static AsyncRenderPipeline* CreateAsyncRenderPipeline(Type*              type,
+                                                      Device*            device,
+                                                      PipelineConstants* constants,
+                                                      PrimitiveTopology  primitiveTopology,
+                                                      FrontFace          frontFace,
+                                                      CullMode           cullMode,
+                                                      BlendState*        blendState) {
+  if (!type->IsClass()) { return nullptr; }
+  auto* This = new AsyncRenderPipeline();
+  auto cached = device->renderPipelines.find(
+      RenderPipelineKey(type, constants, primitiveTopology, frontFace, cullMode, blendState));
+  if (cached != device->renderPipelines.end()) {
+    device->cacheHits++;
+    This->result->pipeline = cached->second;
+    This->result->done = true;
+    return This;
+  }
+  device->cacheMisses++;
+  if (!BuildRenderPipeline(static_cast<ClassType*>(type), device, constants, primitiveTopology,
+                           frontFace, cullMode, blendState,
+                           [&](const wgpu::RenderPipelineDescriptor& desc) {
+                             This->future = device->device.CreateRenderPipelineAsync(
+                                 &desc, wgpu::CallbackMode::WaitAnyOnly,
+                                 This->OnCreated());
+                           })) {
+    This->result->done = true;
+  }
+  return This;
+}
+
+AsyncRenderPipeline* AsyncRenderPipeline_AsyncRenderPipeline_Device_PrimitiveTopology_FrontFace_CullMode_DepthStencilState_BlendState(
+    int                qualifiers,
+    Type*              type,
+    Device*            device,
+    PrimitiveTopology  primitiveTopology,
+    FrontFace          frontFace,
+    CullMode           cullMode,
+    DepthStencilState* depthStencil,
+    BlendState*        blendState) {
+  return CreateAsyncRenderPipeline(type, device, nullptr, primitiveTopology, frontFace, cullMode,
+                                   blendState);
+}
+
+AsyncRenderPipeline* AsyncRenderPipeline_AsyncRenderPipeline_Device_PipelineConstants_PrimitiveTopology_FrontFace_CullMode_DepthStencilState_BlendState(
+    int                qualifiers,
+    Type*              type,
+    Device*            device,
+    PipelineConstants* constants,
+    PrimitiveTopology  primitiveTopology,
+    FrontFace          frontFace,
+    CullMode           cullMode,
+    DepthStencilState* depthStencil,
+    BlendState*        blendState) {
+  return CreateAsyncRenderPipeline(type, device, constants, primitiveTopology, frontFace,
+                                   cullMode, blendState);
+}
+
+void AsyncRenderPipeline_Destroy(AsyncRenderPipeline* This) { delete This; }
+
+bool AsyncRenderPipeline_IsReady(AsyncRenderPipeline* This) { return This->IsReady(); }
+
+void AsyncRenderPipeline_Wait(AsyncRenderPipeline* This) { This->Wait(); }
+
+RenderPipeline* AsyncRenderPipeline_Get(AsyncRenderPipeline* This) {
+  wgpu::RenderPipeline pipeline = This->Wait();
+  return pipeline ? new RenderPipeline(pipeline) : nullptr;
+}
+
+static AsyncComputePipeline* CreateAsyncComputePipeline(Type*              computeLayout,
+                                                        Device*            device,
+                                                        PipelineConstants* constants) {
+  if (!computeLayout->IsClass()) { return nullptr; }
+  auto* This = new AsyncComputePipeline();
+  auto  cached = device->computePipelines.find(ComputePipelineKey(computeLayout, constants));
+  if (cached != device->computePipelines.end()) {
+    device->cacheHits++;
+    This->result->pipeline = cached->second;
+    This->result->done = true;
+    return This;
+  }
+  device->cacheMisses++;
+  if (!BuildComputePipeline(static_cast<ClassType*>(computeLayout), device, constants,
+                            [&](const wgpu::ComputePipelineDescriptor& desc) {
+                              This->future = device->device.CreateComputePipelineAsync(
+                                  &desc, wgpu::CallbackMode::WaitAnyOnly,
+                                  This->OnCreated());
+                            })) {
+    This->result->done = true;
+  }
+  return This;
+}
+
+AsyncComputePipeline* AsyncComputePipeline_AsyncComputePipeline_Device(int     qualifiers,
+                                                                       Type*   computeLayout,
+                                                                       Device* device) {
+  return CreateAsyncComputePipeline(computeLayout, device, nullptr);
+}
+
+AsyncComputePipeline* AsyncComputePipeline_AsyncComputePipeline_Device_PipelineConstants(
+    int                qualifiers,
+    Type*              computeLayout,
+    Device*            device,
+    PipelineConstants* constants) {
+  return CreateAsyncComputePipeline(computeLayout, device, constants);
+}
+
+void AsyncComputePipeline_Destroy(AsyncComputePipeline* This) { delete This; }
+
+bool AsyncComputePipeline_IsReady(AsyncComputePipeline* This) { return This->IsReady(); }
+
+void AsyncComputePipeline_Wait(AsyncComputePipeline* This) { This->Wait(); }
+
+ComputePipeline* AsyncComputePipeline_Get(AsyncComputePipeline* This) {
+  wgpu::ComputePipeline pipeline = This->Wait();
+  return pipeline ? new ComputePipeline(pipeline) : nullptr;
+}
+
 BindGroup* BindGroup_BindGroup(int qualifiers, Type* type, Device* device, void* data) {
   assert(type->IsClass() && "bind group argument must be a class type");
   ClassType*                        classType = static_cast<ClassType*>(type);
   wgpu::BindGroupDescriptor         desc;
   std::vector<wgpu::BindGroupEntry> entries;
+  Leases                            leases;
   desc.entryCount = classType->GetFields().size();
   for (int i = 0; i < desc.entryCount; i++) {
     Field* field = classType->GetFields()[i].get();
     Object* object = reinterpret_cast<Object*>((uint8_t*)data + field->offset);
-    entries.push_back(CreateBindGroupEntry(field->type, i, object->ptr));
+    entries.push_back(CreateBindGroupEntry(field->type, i, object->ptr, &leases));
   }
   desc.entries = entries.data();
   desc.layout = GetOrCreateBindGroupLayout(device, classType);
-  return new BindGroup(device->device.CreateBindGroup(&desc));
+  return new BindGroup(device->device.CreateBindGroup(&desc), std::move(leases));
 }
 
 void BindGroup_Destroy(BindGroup* This) { delete This; }
@@ -973,17 +1793,40 @@ void Texture1D_CopyFromBuffer(Texture1D*      dest,
                               uint32_t        origin,
                               uint32_t        mipLevel) {
   dest->CopyFromBuffer(encoder->encoder, source->buffer, {width, 1, 1}, {origin, 0, 0}, mipLevel);
+  AddLease(encoder->leases.get(), dest->lease);
+  AddLease(encoder->leases.get(), source->lease);
+}
+
+void Texture1D_Write(Texture1D* dest,
+                     Array*     data,
+                     uint32_t   width,
+                     uint32_t   origin,
+                     uint32_t   mipLevel) {
+  dest->Write(data, {width, 1, 1}, {origin, 0, 0}, mipLevel);
 }
 
-Texture2D* Texture2D_Texture2D(int qualifiers, Type* format, Device* device, const uint32_t* size, uint32_t mipLevelCount) {
+Texture2D* Texture2D_Texture2D_Device_uint2_uint(int             qualifiers,
+                                                 Type*           format,
+                                                 Device*         device,
+                                                 const uint32_t* size,
+                                                 uint32_t        mipLevelCount) {
   return new Texture2D(qualifiers, format, device->device, wgpu::TextureDimension::e2D,
                        {size[0], size[1], 1}, mipLevelCount);
 }
 
+Texture2D* Texture2D_Texture2D_TransientPool_uint2_uint(int             qualifiers,
+                                                        Type*           format,
+                                                        TransientPool*  pool,
+                                                        const uint32_t* size,
+                                                        uint32_t        mipLevelCount) {
+  return new Texture2D(qualifiers, format, pool->device, wgpu::TextureDimension::e2D,
+                       {size[0], size[1], 1}, mipLevelCount, pool->cache);
+}
+
 void Texture2D_Destroy(Texture2D* This) { delete This; }
 
 SampleableTexture2D* Texture2D_CreateSampleableView(Texture2D* This, uint32_t baseMipLevel, uint32_t mipLevelCount) {
-  return new SampleableTexture2D(This->CreateView(baseMipLevel, mipLevelCount));
+  return new SampleableTexture2D(This->CreateView(baseMipLevel, mipLevelCount), This->lease);
 }
 
 Texture2D* Texture2D_CreateRenderableView(Texture2D* This, uint32_t mipLevel) {
@@ -1003,7 +1846,7 @@ ColorOutput* Texture2D_CreateColorOutput(Texture2D*   This,
   attachment.loadOp = ToDawnLoadOp(loadOp);
   attachment.storeOp = ToDawnStoreOp(storeOp);
   attachment.view = This->view;
-  return new ColorOutput(attachment);
+  return new ColorOutput(attachment, This->lease);
 }
 
 DepthStencilOutput* Texture2D_CreateDepthStencilOutput(Texture2D* This,
@@ -1021,11 +1864,16 @@ DepthStencilOutput* Texture2D_CreateDepthStencilOutput(Texture2D* This,
   attachment.stencilLoadOp = ToDawnLoadOp(stencilLoadOp);
   attachment.stencilStoreOp = ToDawnStoreOp(stencilStoreOp);
   attachment.stencilClearValue = stencilClearValue;
-  return new DepthStencilOutput(attachment);
+  return new DepthStencilOutput(attachment, This->lease);
 }
 
 uint32_t Texture2D_MinBufferWidth(Texture2D* This) { return This->MinBufferWidth(); }
 
+void Texture2D_GenerateMipmaps(Texture2D* This, CommandEncoder* encoder) {
+  GenerateMipmaps(This->device, encoder->mipmapPipelines.get(), encoder->encoder, This->texture);
+  AddLease(encoder->leases.get(), This->lease);
+}
+
 const uint32_t* Texture2D_GetSize(Texture2D* This, uint32_t mipLevel) {
   return This->Get2DSize(mipLevel);
 }
@@ -1038,6 +1886,28 @@ void Texture2D_CopyFromBuffer(Texture2D*      dest,
                               uint32_t        mipLevel) {
   dest->CopyFromBuffer(encoder->encoder, source->buffer, {size[0], size[1], 1},
                        {origin[0], origin[1], 0}, mipLevel);
+  AddLease(encoder->leases.get(), dest->lease);
+  AddLease(encoder->leases.get(), source->lease);
+}
+
+void Texture2D_CopyToBuffer(Texture2D*      source,
+                            CommandEncoder* encoder,
+                            Buffer*         dest,
+                            const uint32_t* size,
+                            const uint32_t* origin,
+                            uint32_t        mipLevel) {
+  source->CopyToBuffer(encoder->encoder, dest->buffer, {size[0], size[1], 1},
+                       {origin[0], origin[1], 0}, mipLevel);
+  AddLease(encoder->leases.get(), source->lease);
+  AddLease(encoder->leases.get(), dest->lease);
+}
+
+void Texture2D_Write(Texture2D*      dest,
+                     Array*          data,
+                     const uint32_t* size,
+                     const uint32_t* origin,
+                     uint32_t        mipLevel) {
+  dest->Write(data, {size[0], size[1], 1}, {origin[0], origin[1], 0}, mipLevel);
 }
 
 Texture2DArray* Texture2DArray_Texture2DArray(int             qualifiers,
@@ -1081,6 +1951,11 @@ Texture2DArray* Texture2DArray_CreateStorageView(Texture2DArray* This,
 
 uint32_t Texture2DArray_MinBufferWidth(Texture2DArray* This) { return This->MinBufferWidth(); }
 
+void Texture2DArray_GenerateMipmaps(Texture2DArray* This, CommandEncoder* encoder) {
+  GenerateMipmaps(This->device, encoder->mipmapPipelines.get(), encoder->encoder, This->texture);
+  AddLease(encoder->leases.get(), This->lease);
+}
+
 void Texture2DArray_CopyFromBuffer(Texture2DArray* dest,
                                    CommandEncoder* encoder,
                                    Buffer*         source,
@@ -1091,6 +1966,18 @@ void Texture2DArray_CopyFromBuffer(Texture2DArray* dest,
                                    uint32_t        mipLevel) {
   dest->CopyFromBuffer(encoder->encoder, source->buffer, {size[0], size[1], numLayers},
                        {origin[0], origin[1], layer}, mipLevel);
+  AddLease(encoder->leases.get(), dest->lease);
+  AddLease(encoder->leases.get(), source->lease);
+}
+
+void Texture2DArray_Write(Texture2DArray* dest,
+                          Array*          data,
+                          const uint32_t* size,
+                          uint32_t        layer,
+                          uint32_t        numLayers,
+                          const uint32_t* origin,
+                          uint32_t        mipLevel) {
+  dest->Write(data, {size[0], size[1], numLayers}, {origin[0], origin[1], layer}, mipLevel);
 }
 
 Texture3D* Texture3D_Texture3D(int qualifiers, Type* format, Device* device, const uint32_t* size, uint32_t mipLevelCount) {
@@ -1122,6 +2009,11 @@ Texture3D* Texture3D_CreateStorageView(Texture2D* This, uint32_t baseDepth, uint
 
 uint32_t Texture3D_MinBufferWidth(Texture3D* This) { return This->MinBufferWidth(); }
 
+void Texture3D_GenerateMipmaps(Texture3D* This, CommandEncoder* encoder) {
+  GenerateMipmaps(This->device, encoder->mipmapPipelines.get(), encoder->encoder, This->texture);
+  AddLease(encoder->leases.get(), This->lease);
+}
+
 void Texture3D_CopyFromBuffer(Texture3D*      dest,
                               CommandEncoder* encoder,
                               Buffer*         source,
@@ -1130,6 +2022,16 @@ void Texture3D_CopyFromBuffer(Texture3D*      dest,
                               uint32_t        mipLevel) {
   dest->CopyFromBuffer(encoder->encoder, source->buffer, {size[0], size[1], size[2]},
                        {origin[0], origin[1], origin[2]}, mipLevel);
+  AddLease(encoder->leases.get(), dest->lease);
+  AddLease(encoder->leases.get(), source->lease);
+}
+
+void Texture3D_Write(Texture3D*      dest,
+                     Array*          data,
+                     const uint32_t* size,
+                     const uint32_t* origin,
+                     uint32_t        mipLevel) {
+  dest->Write(data, {size[0], size[1], size[2]}, {origin[0], origin[1], origin[2]}, mipLevel);
 }
 
 TextureCube* TextureCube_TextureCube(int             qualifiers,
@@ -1161,6 +2063,11 @@ TextureCube* TextureCube_CreateStorageView(TextureCube* This, uint32_t face, uin
 
 uint32_t TextureCube_MinBufferWidth(TextureCube* This) { return This->MinBufferWidth(); }
 
+void TextureCube_GenerateMipmaps(TextureCube* This, CommandEncoder* encoder) {
+  GenerateMipmaps(This->device, encoder->mipmapPipelines.get(), encoder->encoder, This->texture);
+  AddLease(encoder->leases.get(), This->lease);
+}
+
 void TextureCube_CopyFromBuffer(TextureCube*    dest,
                                 CommandEncoder* encoder,
                                 Buffer*         source,
@@ -1171,6 +2078,18 @@ void TextureCube_CopyFromBuffer(TextureCube*    dest,
                                 uint32_t        mipLevel) {
   dest->CopyFromBuffer(encoder->encoder, source->buffer, {size[0], size[1], numFaces},
                        {origin[0], origin[1], face}, mipLevel);
+  AddLease(encoder->leases.get(), dest->lease);
+  AddLease(encoder->leases.get(), source->lease);
+}
+
+void TextureCube_Write(TextureCube*    dest,
+                       Array*          data,
+                       const uint32_t* size,
+                       uint32_t        face,
+                       uint32_t        numFaces,
+                       const uint32_t* origin,
+                       uint32_t        mipLevel) {
+  dest->Write(data, {size[0], size[1], numFaces}, {origin[0], origin[1], face}, mipLevel);
 }
 
 Sampler* Sampler_Sampler(Device*     device,
@@ -1195,23 +2114,59 @@ void Sampler_Destroy(Sampler* This) { delete This; }
 
 void Buffer_CopyFromBuffer(Buffer* This, CommandEncoder* encoder, Buffer* source) {
   encoder->encoder.CopyBufferToBuffer(source->buffer, 0, This->buffer, 0, source->sizeInBytes);
+  AddLease(encoder->leases.get(), source->lease);
+  AddLease(encoder->leases.get(), This->lease);
+}
+
+// Starts mapping the buffer, unless a map is already pending or complete. Callbacks run from
+// WaitAny() or Device.ProcessEvents().
+static MapRequest* MapAsync(wgpu::MapMode mapMode, Buffer* buffer) {
+  if (!buffer->pendingMap ||
+      (buffer->pendingMap->done &&
+       buffer->buffer.GetMapState() == wgpu::BufferMapState::Unmapped)) {
+    auto result = std::make_shared<MapResult>();
+    if (buffer->buffer.GetMapState() == wgpu::BufferMapState::Mapped) {
+      result->status = wgpu::MapAsyncStatus::Success;
+      result->done = true;
+    } else {
+      buffer->pendingMapFuture =
+          buffer->buffer.MapAsync(mapMode, 0, buffer->sizeInBytes,
+                                  wgpu::CallbackMode::AllowProcessEvents,
+                                  [result](wgpu::MapAsyncStatus s, wgpu::StringView) {
+                                    result->status = s;
+                                    result->done = true;
+                                  });
+    }
+    buffer->pendingMap = result;
+  }
+  return new MapRequest(buffer->pendingMap, buffer->pendingMapFuture);
+}
+
+static bool WaitForMap(std::shared_ptr<MapResult> result, wgpu::Future future, uint64_t timeout) {
+  if (!result->done) {
+    wgpu::FutureWaitInfo waitInfo = {future};
+    gInstance.WaitAny(1, &waitInfo, timeout);
+  }
+  return result->done;
+}
+
+// True if the buffer's current mapping has already been handed out, as opposed to a mapping
+// completed by MapReadAsync() or MapWriteAsync() which has no Object yet.
+static bool HasMappedObject(Buffer* buffer) {
+  auto it = gMappedBuffers.find(buffer->mappedObject.ptr);
+  return it != gMappedBuffers.end() && it->second.Get() == buffer->buffer.Get();
 }
 
 static Object* MapSync(wgpu::MapMode mapMode, Buffer* buffer) {
-  if (buffer->buffer.GetMapState() == wgpu::BufferMapState::Mapped) {
+  if (HasMappedObject(buffer)) {
     buffer->mappedObject.controlBlock->weakRefs++;
     buffer->mappedObject.controlBlock->strongRefs++;
     return &buffer->mappedObject;
   }
 
-  wgpu::MapAsyncStatus mapStatus = wgpu::MapAsyncStatus::Error;
-  wgpu::Future future = buffer->buffer.MapAsync(mapMode, 0, buffer->sizeInBytes, wgpu::CallbackMode::WaitAnyOnly,
-                                                [&mapStatus](wgpu::MapAsyncStatus s, wgpu::StringView) {
-                                                  mapStatus = s;
-                                                });
-  wgpu::FutureWaitInfo waitInfo = {future};
-  if (gInstance.WaitAny(1, &waitInfo, UINT64_MAX) != wgpu::WaitStatus::Success
-      || mapStatus != wgpu::MapAsyncStatus::Success) {
+  std::unique_ptr<MapRequest> request(MapAsync(mapMode, buffer));
+  WaitForMap(request->result, request->future, UINT64_MAX);
+  if (request->result->status != wgpu::MapAsyncStatus::Success) {
     return &buffer->mappedObject;
   }
 
@@ -1239,15 +2194,43 @@ static Object* MapSync(wgpu::MapMode mapMode, Buffer* buffer) {
   return &buffer->mappedObject;
 }
 
+static Buffer* CreateBuffer(int                                     qualifiers,
+                           Type*                                   type,
+                           wgpu::Device                            device,
+                           uint32_t                                dynamicArraySize,
+                           std::shared_ptr<TransientResourceCache> cache) {
+  wgpu::BufferDescriptor desc;
+  desc.usage = toDawnBufferUsage(qualifiers);
+  desc.size = type->GetSizeInBytes(dynamicArraySize);
+  uint32_t dynamicStride = 0;
+  if (qualifiers & Type::Qualifier::Dynamic) {
+    // For dynamic buffers, the size is the number of elements.
+    dynamicStride = DynamicStride(type);
+    desc.size = dynamicStride * std::max(dynamicArraySize, 1u);
+  }
+  // Writes and copies are made in whole 4-byte words, so round the size up to cover the last.
+  desc.size = (desc.size + 3) & ~3ull;
+  // Host-mappable buffers carry map state between uses, so they are never pooled.
+  if (desc.usage & (wgpu::BufferUsage::MapRead | wgpu::BufferUsage::MapWrite)) { cache = nullptr; }
+  wgpu::Buffer b = cache ? cache->AcquireBuffer(device, desc) : device.CreateBuffer(&desc);
+  auto         result = new Buffer(device, b, dynamicArraySize, desc.size, type);
+  result->dynamicStride = dynamicStride;
+  if (cache) { result->lease = MakeLease(cache, b); }
+  return result;
+}
+
 Buffer* Buffer_Buffer_Device_uint(int      qualifiers,
                                   Type*    type,
                                   Device*  device,
                                   uint32_t dynamicArraySize) {
-  wgpu::BufferDescriptor desc;
-  desc.usage = toDawnBufferUsage(qualifiers);
-  desc.size = type->GetSizeInBytes(dynamicArraySize);
-  wgpu::Buffer b = device->device.CreateBuffer(&desc);
-  return new Buffer(device->device, b, dynamicArraySize, desc.size, type);
+  return CreateBuffer(qualifiers, type, device->device, dynamicArraySize, nullptr);
+}
+
+Buffer* Buffer_Buffer_TransientPool_uint(int            qualifiers,
+                                         Type*          type,
+                                         TransientPool* pool,
+                                         uint32_t       dynamicArraySize) {
+  return CreateBuffer(qualifiers, type, pool->device, dynamicArraySize, pool->cache);
 }
 
 Buffer* Buffer_Buffer_Device_T(int qualifiers, Type* type, Device* device, void* data) {
@@ -1262,6 +2245,39 @@ Object* Buffer_MapRead(Buffer* buffer) { return MapSync(wgpu::MapMode::Read, buf
 
 Object* Buffer_MapWrite(Buffer* buffer) { return MapSync(wgpu::MapMode::Write, buffer); }
 
+MapRequest* Buffer_MapReadAsync(Buffer* buffer) { return MapAsync(wgpu::MapMode::Read, buffer); }
+
+MapRequest* Buffer_MapWriteAsync(Buffer* buffer) { return MapAsync(wgpu::MapMode::Write, buffer); }
+
+void MapRequest_Destroy(MapRequest* This) { delete This; }
+
+bool MapRequest_IsReady(MapRequest* This) { return WaitForMap(This->result, This->future, 0); }
+
+bool MapRequest_Wait(MapRequest* This) {
+  WaitForMap(This->result, This->future, UINT64_MAX);
+  return This->result->status == wgpu::MapAsyncStatus::Success;
+}
+
+// Writes size bytes of data at offset. WriteBuffer() only writes whole 4-byte words, so the
+// write must start on a word and end on one, or at the end of the buffer. There the last word
+// is padded with zeros, which only land in the padding CreateBuffer() added. Returns false if
+// the range is not aligned, rather than overwriting neighbouring bytes on the GPU.
+static bool WriteBufferPadded(Buffer* buffer, uint64_t offset, const void* data, uint64_t size) {
+  uint64_t bufferSize = static_cast<uint64_t>(buffer->sizeInBytes);
+  if (offset >= bufferSize) { return true; }
+  size = std::min(size, bufferSize - offset);
+  if ((offset & 3) != 0 || ((size & 3) != 0 && offset + size != bufferSize)) { return false; }
+  wgpu::Queue queue = buffer->device.GetQueue();
+  uint64_t    alignedSize = size & ~3ull;
+  if (alignedSize > 0) { queue.WriteBuffer(buffer->buffer, offset, data, alignedSize); }
+  if (alignedSize < size) {
+    uint8_t tail[4] = {};
+    memcpy(tail, static_cast<const uint8_t*>(data) + alignedSize, size - alignedSize);
+    queue.WriteBuffer(buffer->buffer, offset + alignedSize, tail, sizeof(tail));
+  }
+  return true;
+}
+
 void Buffer_Set(Buffer* buffer, void* data) {
   Type* type = buffer->type;
   assert(!type->IsPtr());
@@ -1271,67 +2287,480 @@ void Buffer_Set(Buffer* buffer, void* data) {
     length = array->length;
     data = array->ptr;
   }
-  wgpu::Queue queue = buffer->device.GetQueue();
-  queue.WriteBuffer(buffer->buffer, 0, data, type->GetSizeInBytes(length));
+  if (!WriteBufferPadded(buffer, 0, data, type->GetSizeInBytes(length))) {
+    fprintf(stderr,
+            "Buffer.Set(): data must fill the buffer or be a whole number of 4-byte words\n");
+  }
+}
+
+void Buffer_SetElement(Buffer* buffer, uint32_t index, void* data) {
+  assert(buffer->dynamicStride);
+  uint64_t offset = static_cast<uint64_t>(index) * buffer->dynamicStride;
+  if (offset + buffer->dynamicStride > buffer->sizeInBytes) { return; }
+  if (!WriteBufferPadded(buffer, offset, data, buffer->type->GetSizeInBytes())) {
+    assert(!"dynamic stride is not a multiple of 4");
+  }
+}
+
+void Buffer_SetRange(Buffer* buffer, void* data, uint32_t offset, uint32_t count) {
+  Type* type = buffer->type;
+  assert(!type->IsPtr());
+  if (!type->IsArray()) {
+    Buffer_Set(buffer, data);
+    return;
+  }
+  auto     arrayType = static_cast<ArrayType*>(type);
+  uint32_t length = arrayType->GetNumElements();
+  if (type->IsUnsizedArray()) {
+    Array* array = static_cast<Array*>(data);
+    length = array->length;
+    data = array->ptr;
+  }
+  uint64_t elementSize = arrayType->GetElementSizeInBytes();
+  uint64_t start = std::min<uint64_t>(offset, length) * elementSize;
+  uint64_t end = std::min<uint64_t>(static_cast<uint64_t>(offset) + count, length) * elementSize;
+  if (start >= end) { return; }
+  if (!WriteBufferPadded(buffer, start, static_cast<uint8_t*>(data) + start, end - start)) {
+    fprintf(stderr, "Buffer.SetRange(): range must start and end on a 4-byte boundary\n");
+  }
 }
 
 void Buffer_Destroy(Buffer* This) { delete This; }
 
+// A set of host-readable staging buffers which are copied into in turn. Each slot moves from
+// Free to Copied (the copy is recorded but may not be submitted yet), then to Mapping once
+// GetLatest() starts a map after the submit, then to Ready. The newest Ready slot is handed
+// out, and becomes Free again once its data is released. A Copied slot whose command buffer
+// is destroyed without being submitted is freed.
+struct ReadbackRing {
+  enum class State { Free, Copied, Mapping, Ready, HandedOut };
+  struct Slot {
+    std::unique_ptr<Buffer>    buffer;
+    State                      state = State::Free;
+    uint32_t                   frame = 0;
+    std::shared_ptr<bool>      submitted;
+    std::shared_ptr<MapResult> map;
+  };
+  void Update(bool startMaps) {
+    for (auto& slot : slots) {
+      if (slot.state == State::Copied && !*slot.submitted && slot.submitted.use_count() == 1) {
+        slot.state = State::Free;
+        slot.submitted = nullptr;
+      } else if (slot.state == State::Copied && *slot.submitted && startMaps) {
+        std::unique_ptr<MapRequest> request(MapAsync(wgpu::MapMode::Read, slot.buffer.get()));
+        slot.map = request->result;
+        slot.state = State::Mapping;
+        slot.submitted = nullptr;
+      }
+      if (slot.state == State::Mapping && slot.map->done) {
+        bool success = slot.map->status == wgpu::MapAsyncStatus::Success;
+        slot.state = success ? State::Ready : State::Free;
+        slot.map = nullptr;
+      } else if (slot.state == State::HandedOut &&
+                 slot.buffer->buffer.GetMapState() == wgpu::BufferMapState::Unmapped) {
+        slot.state = State::Free;
+      }
+    }
+  }
+  std::vector<Slot> slots;
+  uint32_t          nextFrame = 0;
+  uint32_t          latestFrame = 0;
+  bool              handedOut = false;  // whether latestFrame has been set
+  Object            none = {nullptr, nullptr};
+};
+
+ReadbackRing* ReadbackRing_ReadbackRing(int      qualifiers,
+                                        Type*    type,
+                                        Device*  device,
+                                        uint32_t size,
+                                        uint32_t count) {
+  auto* This = new ReadbackRing();
+  This->slots.resize(std::max(count, 1u));
+  for (auto& slot : This->slots) {
+    slot.buffer.reset(Buffer_Buffer_Device_uint(Type::Qualifier::HostReadable, type, device, size));
+  }
+  return This;
+}
+
+void ReadbackRing_Destroy(ReadbackRing* This) { delete This; }
+
+bool ReadbackRing_Copy(ReadbackRing* This, CommandEncoder* encoder, Buffer* source) {
+  This->Update(false);
+  for (auto& slot : This->slots) {
+    if (slot.state != ReadbackRing::State::Free) { continue; }
+    Buffer* dest = slot.buffer.get();
+    encoder->encoder.CopyBufferToBuffer(source->buffer, 0, dest->buffer, 0,
+                                        std::min(source->sizeInBytes, dest->sizeInBytes));
+    AddLease(encoder->leases.get(), source->lease);
+    slot.state = ReadbackRing::State::Copied;
+    slot.frame = This->nextFrame++;
+    slot.submitted = std::make_shared<bool>(false);
+    encoder->submitFlags.push_back(slot.submitted);
+    return true;
+  }
+  return false;
+}
+
+Object* ReadbackRing_GetLatest(ReadbackRing* This) {
+  gInstance.ProcessEvents();
+  This->Update(true);
+  ReadbackRing::Slot* latest = nullptr;
+  for (auto& slot : This->slots) {
+    if (slot.state != ReadbackRing::State::Ready) { continue; }
+    ReadbackRing::Slot* stale = &slot;
+    if (This->handedOut && slot.frame <= This->latestFrame) {
+      // Older than a frame already handed out, so it would move GetLatestFrame() backwards.
+    } else if (!latest || latest->frame < slot.frame) {
+      // Superseded before it was ever handed out.
+      stale = latest;
+      latest = &slot;
+    }
+    if (stale) {
+      stale->buffer->buffer.Unmap();
+      stale->state = ReadbackRing::State::Free;
+    }
+  }
+  if (!latest) { return &This->none; }
+  latest->state = ReadbackRing::State::HandedOut;
+  This->latestFrame = latest->frame;
+  This->handedOut = true;
+  return MapSync(wgpu::MapMode::Read, latest->buffer.get());
+}
+
+uint32_t ReadbackRing_GetLatestFrame(ReadbackRing* This) { return This->latestFrame; }
+
+// A set of timestamp queries. Where the device lacks timestamp support the query set is null,
+// and passes and resolves which use it carry on without writing timestamps.
+struct QuerySet {
+  QuerySet(wgpu::QuerySet q, uint32_t c) : querySet(q), count(c) {}
+  wgpu::QuerySet querySet;
+  uint32_t       count;
+  wgpu::Buffer   resolveBuffer;  // resolved into, then copied to the caller's storage buffer
+};
+
+static wgpu::QuerySet CreateTimestampQuerySet(wgpu::Device device, uint32_t count) {
+  if (!device.HasFeature(wgpu::FeatureName::TimestampQuery)) { return nullptr; }
+  wgpu::QuerySetDescriptor desc;
+  desc.type = wgpu::QueryType::Timestamp;
+  desc.count = count;
+  return device.CreateQuerySet(&desc);
+}
+
+QuerySet* QuerySet_QuerySet(Device* device, uint32_t count) {
+  auto* result = new QuerySet(CreateTimestampQuerySet(device->device, count), count);
+  if (!result->querySet) { return result; }
+  wgpu::BufferDescriptor desc;
+  desc.size = count * sizeof(uint64_t);
+  desc.usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc;
+  result->resolveBuffer = device->device.CreateBuffer(&desc);
+  return result;
+}
+
+void QuerySet_Destroy(QuerySet* This) { delete This; }
+
+bool QuerySet_IsSupported(QuerySet* This) { return This->querySet != nullptr; }
+
+void CommandEncoder_ResolveQuerySet(CommandEncoder* This,
+                                    QuerySet*       querySet,
+                                    uint32_t        firstQuery,
+                                    uint32_t        queryCount,
+                                    Buffer*         destination) {
+  if (!querySet->querySet) { return; }
+  This->encoder.ResolveQuerySet(querySet->querySet, firstQuery, queryCount,
+                                querySet->resolveBuffer, 0);
+  This->encoder.CopyBufferToBuffer(querySet->resolveBuffer, 0, destination->buffer, 0,
+                                   queryCount * sizeof(uint64_t));
+  AddLease(This->leases.get(), destination->lease);
+}
+
+// Times each pass constructed with it, using a timestamp at the beginning and end of the pass.
+// Resolve() copies the frame's timestamps into one of a few staging buffers, and Update(),
+// called once that frame has been submitted, maps any staging buffers which are ready and
+// converts the newest frame's timestamps to durations.
+struct GPUProfiler {
+  enum class State { Free, Copied, Mapping };
+  struct Slot {
+    wgpu::Buffer               buffer;
+    State                      state = State::Free;
+    uint32_t                   passCount = 0;
+    uint32_t                   frame = 0;
+    std::shared_ptr<MapResult> map;
+  };
+  // Returns false if the pass should not be timed, e.g., the frame's queries are used up.
+  bool AllocatePass(wgpu::PassTimestampWrites* timestampWrites) {
+    if (!querySet || passCount >= maxPasses) { return false; }
+    timestampWrites->querySet = querySet;
+    timestampWrites->beginningOfPassWriteIndex = passCount * 2;
+    timestampWrites->endOfPassWriteIndex = passCount * 2 + 1;
+    passCount++;
+    return true;
+  }
+  wgpu::QuerySet     querySet;
+  wgpu::Buffer       resolveBuffer;
+  uint32_t           maxPasses;
+  uint32_t           passCount = 0;
+  std::vector<Slot>  slots;
+  uint32_t           nextFrame = 0;
+  uint32_t           latestFrame = 0;
+  std::vector<float> durations;  // in milliseconds
+};
+
+GPUProfiler* GPUProfiler_GPUProfiler(Device* device, uint32_t maxPasses) {
+  constexpr uint32_t kSlotCount = 3;
+  auto*              This = new GPUProfiler();
+  This->maxPasses = std::max(maxPasses, 1u);
+  This->querySet = CreateTimestampQuerySet(device->device, This->maxPasses * 2);
+  if (!This->querySet) { return This; }
+  wgpu::BufferDescriptor desc;
+  desc.size = This->maxPasses * 2 * sizeof(uint64_t);
+  desc.usage = wgpu::BufferUsage::QueryResolve | wgpu::BufferUsage::CopySrc;
+  This->resolveBuffer = device->device.CreateBuffer(&desc);
+  desc.usage = wgpu::BufferUsage::MapRead | wgpu::BufferUsage::CopyDst;
+  This->slots.resize(kSlotCount);
+  for (auto& slot : This->slots) {
+    slot.buffer = device->device.CreateBuffer(&desc);
+  }
+  return This;
+}
+
+void GPUProfiler_Destroy(GPUProfiler* This) { delete This; }
+
+bool GPUProfiler_IsSupported(GPUProfiler* This) { return This->querySet != nullptr; }
+
+void GPUProfiler_Resolve(GPUProfiler* This, CommandEncoder* encoder) {
+  uint32_t passCount = This->passCount;
+  This->passCount = 0;
+  if (passCount == 0) { return; }
+  for (auto& slot : This->slots) {
+    if (slot.state != GPUProfiler::State::Free) { continue; }
+    uint64_t size = passCount * 2 * sizeof(uint64_t);
+    encoder->encoder.ResolveQuerySet(This->querySet, 0, passCount * 2, This->resolveBuffer, 0);
+    encoder->encoder.CopyBufferToBuffer(This->resolveBuffer, 0, slot.buffer, 0, size);
+    slot.state = GPUProfiler::State::Copied;
+    slot.passCount = passCount;
+    slot.frame = This->nextFrame++;
+    return;
+  }
+  // Every staging buffer is still in flight, so this frame's timings are dropped.
+}
+
+void GPUProfiler_Update(GPUProfiler* This) {
+  gInstance.ProcessEvents();
+  for (auto& slot : This->slots) {
+    uint64_t size = slot.passCount * 2 * sizeof(uint64_t);
+    if (slot.state == GPUProfiler::State::Copied) {
+      auto result = std::make_shared<MapResult>();
+      slot.buffer.MapAsync(wgpu::MapMode::Read, 0, size, wgpu::CallbackMode::AllowProcessEvents,
+                           [result](wgpu::MapAsyncStatus s, wgpu::StringView) {
+                             result->status = s;
+                             result->done = true;
+                           });
+      slot.map = result;
+      slot.state = GPUProfiler::State::Mapping;
+    } else if (slot.state == GPUProfiler::State::Mapping && slot.map->done) {
+      if (slot.map->status == wgpu::MapAsyncStatus::Success) {
+        if (This->durations.empty() || slot.frame > This->latestFrame) {
+          auto timestamps = static_cast<const uint64_t*>(slot.buffer.GetConstMappedRange(0, size));
+          This->durations.resize(slot.passCount);
+          for (uint32_t i = 0; i < slot.passCount; ++i) {
+            uint64_t begin = timestamps[i * 2], end = timestamps[i * 2 + 1];
+            // Timestamps are in nanoseconds, but may go backwards on some implementations.
+            This->durations[i] = end > begin ? static_cast<float>(end - begin) / 1000000.0f : 0.0f;
+          }
+          This->latestFrame = slot.frame;
+        }
+        slot.buffer.Unmap();
+      }
+      slot.map = nullptr;
+      slot.state = GPUProfiler::State::Free;
+    }
+  }
+}
+
+uint32_t GPUProfiler_GetPassCount(GPUProfiler* This) { return This->durations.size(); }
+
+float GPUProfiler_GetPassDuration(GPUProfiler* This, uint32_t pass) {
+  return pass < This->durations.size() ? This->durations[pass] : 0.0f;
+}
+
+uint32_t GPUProfiler_GetLatestFrame(GPUProfiler* This) { return This->latestFrame; }
+
 CommandEncoder* CommandEncoder_CommandEncoder(Device* device) {
   wgpu::CommandEncoderDescriptor desc;
-  return new CommandEncoder(device->device.CreateCommandEncoder(&desc));
+  return new CommandEncoder(device->device.CreateCommandEncoder(&desc), device->bindingPlans,
+                            device->mipmapPipelines);
 }
 
 void CommandEncoder_Destroy(CommandEncoder* This) { delete This; }
 
-void Queue_Submit(Queue* queue, CommandBuffer* commandBuffer) {
+void Queue_Submit_CommandBuffer(Queue* queue, CommandBuffer* commandBuffer) {
   queue->queue.Submit(1, &commandBuffer->commandBuffer);
+  MarkSubmitted(commandBuffer);
+}
+
+void Queue_Submit_CommandBufferArray(Queue* queue, Array* commandBuffers) {
+  std::vector<wgpu::CommandBuffer> buffers;
+  for (uint32_t i = 0; i < commandBuffers->length; ++i) {
+    auto cb = static_cast<CommandBuffer*>(static_cast<Object*>(commandBuffers->ptr)[i].ptr);
+    if (cb) { buffers.push_back(cb->commandBuffer); }
+  }
+  queue->queue.Submit(buffers.size(), buffers.data());
+  for (uint32_t i = 0; i < commandBuffers->length; ++i) {
+    auto cb = static_cast<CommandBuffer*>(static_cast<Object*>(commandBuffers->ptr)[i].ptr);
+    if (cb) { MarkSubmitted(cb); }
+  }
+}
+
+// Signalled once all work submitted to the queue before its creation has completed. Like
+// MapResult, the outcome is shared with the callback, which may outlive the Fence.
+struct WorkDoneResult {
+  wgpu::QueueWorkDoneStatus status = wgpu::QueueWorkDoneStatus::Error;
+  bool                      done = false;
+};
+
+struct Fence {
+  Fence(std::shared_ptr<WorkDoneResult> r, wgpu::Future f) : result(r), future(f) {}
+  std::shared_ptr<WorkDoneResult> result;
+  wgpu::Future                    future;
+};
+
+Fence* Queue_OnSubmittedWorkDone(Queue* This) {
+  auto         result = std::make_shared<WorkDoneResult>();
+  wgpu::Future future = This->queue.OnSubmittedWorkDone(
+      wgpu::CallbackMode::AllowProcessEvents,
+      [result](wgpu::QueueWorkDoneStatus status, wgpu::StringView) {
+        result->status = status;
+        result->done = true;
+      });
+  return new Fence(result, future);
+}
+
+static bool WaitForFence(Fence* fence, uint64_t timeout) {
+  if (!fence->result->done) {
+    wgpu::FutureWaitInfo waitInfo = {fence->future};
+    gInstance.WaitAny(1, &waitInfo, timeout);
+  }
+  return fence->result->done;
+}
+
+void Fence_Destroy(Fence* This) { delete This; }
+
+bool Fence_IsReady(Fence* This) { return WaitForFence(This, 0); }
+
+bool Fence_Wait(Fence* This) {
+  WaitForFence(This, UINT64_MAX);
+  return This->result->status == wgpu::QueueWorkDoneStatus::Success;
 }
 
 VertexInput* VertexInput_VertexInput(int     qualifiers,
                                      Type*   type,
                                      Buffer* buffer) {
-  return new VertexInput(buffer->buffer);
+  return new VertexInput(buffer->buffer, buffer->lease);
 }
 
 void VertexInput_Destroy(VertexInput* This) { delete This; }
 
+PackedVertexInput* PackedVertexInput_PackedVertexInput(int     qualifiers,
+                                                       Type*   type,
+                                                       Buffer* buffer) {
+  return new PackedVertexInput(buffer->buffer, buffer->lease);
+}
+
+void PackedVertexInput_Destroy(PackedVertexInput* This) { delete This; }
+
 void ColorOutput_Destroy(ColorOutput* This) { delete This; }
 
 void DepthStencilOutput_Destroy(DepthStencilOutput* This) { delete This; }
 
+static RenderPass* BeginRenderPass(Type*                      type,
+                                   CommandEncoder*            encoder,
+                                   void*                      data,
+                                   wgpu::PassTimestampWrites* timestampWrites) {
+  auto plan = GetBindingPlan(encoder->bindingPlans.get(), type);
+  std::vector<wgpu::RenderPassColorAttachment> colorAttachments;
+  wgpu::RenderPassDepthStencilAttachment       depthStencilAttachment;
+  wgpu::RenderPassDescriptor                   desc;
+  for (const auto& entry : plan->entries) {
+    void* ptr = GetFieldPtr(data, entry);
+    if (!ptr) { continue; }
+    if (entry.kind == BindingPlan::Kind::ColorOutput) {
+      colorAttachments.push_back(static_cast<ColorOutput*>(ptr)->attachment);
+      AddLease(encoder->leases.get(), static_cast<ColorOutput*>(ptr)->lease);
+    } else if (entry.kind == BindingPlan::Kind::DepthStencilOutput) {
+      depthStencilAttachment = static_cast<DepthStencilOutput*>(ptr)->attachment;
+      desc.depthStencilAttachment = &depthStencilAttachment;
+      AddLease(encoder->leases.get(), static_cast<DepthStencilOutput*>(ptr)->lease);
+    }
+  }
+  desc.colorAttachmentCount = colorAttachments.size();
+  desc.colorAttachments = colorAttachments.data();
+  desc.timestampWrites = timestampWrites;
+  auto result = new RenderPass(encoder->encoder.BeginRenderPass(&desc), type,
+                               encoder->bindingPlans, plan, encoder->leases);
+  ApplyBindingPlan(*plan, result->encoder, result->state.get(), result->leases.get(), data,
+                   nullptr);
+  return result;
+}
+
 RenderPass* RenderPass_RenderPass_CommandEncoder_T(int             qualifiers,
                                                    Type*           type,
                                                    CommandEncoder* encoder,
                                                    void*           data) {
-  PipelineData pipelineData;
-  ExtractPipelineData(type, data, &pipelineData);
-
-  wgpu::RenderPassDescriptor desc;
-  desc.colorAttachmentCount = pipelineData.colorAttachments.size();
-  desc.colorAttachments = pipelineData.colorAttachments.data();
-  if (pipelineData.depthStencilAttachment.view != nullptr) {
-    desc.depthStencilAttachment = &pipelineData.depthStencilAttachment;
-  }
-  auto result = encoder->encoder.BeginRenderPass(&desc);
-  pipelineData.Set(result);
-  return new RenderPass(result, type);
+  return BeginRenderPass(type, encoder, data, nullptr);
+}
+
+RenderPass* RenderPass_RenderPass_CommandEncoder_T_QuerySet_uint_uint(
+    int             qualifiers,
+    Type*           type,
+    CommandEncoder* encoder,
+    void*           data,
+    QuerySet*       querySet,
+    uint32_t        beginningOfPassWriteIndex,
+    uint32_t        endOfPassWriteIndex) {
+  if (!querySet->querySet) { return BeginRenderPass(type, encoder, data, nullptr); }
+  wgpu::PassTimestampWrites timestampWrites;
+  timestampWrites.querySet = querySet->querySet;
+  timestampWrites.beginningOfPassWriteIndex = beginningOfPassWriteIndex;
+  timestampWrites.endOfPassWriteIndex = endOfPassWriteIndex;
+  return BeginRenderPass(type, encoder, data, &timestampWrites);
+}
+
+RenderPass* RenderPass_RenderPass_CommandEncoder_T_GPUProfiler(int             qualifiers,
+                                                               Type*           type,
+                                                               CommandEncoder* encoder,
+                                                               void*           data,
+                                                               GPUProfiler*    profiler) {
+  wgpu::PassTimestampWrites timestampWrites;
+  bool                      timed = profiler->AllocatePass(&timestampWrites);
+  return BeginRenderPass(type, encoder, data, timed ? &timestampWrites : nullptr);
 }
 
 RenderPass* RenderPass_RenderPass_RenderPass(int qualifiers, Type* type, RenderPass* parent) {
-  return new RenderPass(parent->encoder, type);
+  return new RenderPass(parent->encoder, type, parent->bindingPlans,
+                        GetBindingPlan(parent->bindingPlans.get(), type), parent->leases,
+                        parent->state);
 }
 
-void RenderPass_Set(RenderPass* This, void* data) {
-  PipelineData pipelineData;
-  ExtractPipelineData(This->type, data, &pipelineData);
-  pipelineData.Set(This->encoder);
+void RenderPass_Set_T(RenderPass* This, void* data) {
+  ApplyBindingPlan(*This->plan, This->encoder, This->state.get(), This->leases.get(), data,
+                   nullptr);
+}
+
+void RenderPass_Set_T_uintArray(RenderPass* This, void* data, Array* dynamicIndices) {
+  ApplyBindingPlan(*This->plan, This->encoder, This->state.get(), This->leases.get(), data,
+                   dynamicIndices);
 }
 
 void RenderPass_SetPipeline(RenderPass* This, RenderPipeline* pipeline) {
-  This->encoder.SetPipeline(pipeline->pipeline);
+  if (This->state->SetPipeline(pipeline->pipeline)) {
+    This->encoder.SetPipeline(pipeline->pipeline);
+  }
 }
 
+uint32_t RenderPass_GetCommandsIssued(RenderPass* This) { return This->state->issued; }
+
+uint32_t RenderPass_GetCommandsSkipped(RenderPass* This) { return This->state->skipped; }
+
 void RenderPass_Draw(RenderPass* This,
                      uint32_t    vertexCount,
                      uint32_t    instanceCount,
@@ -1343,43 +2772,189 @@ void RenderPass_Draw(RenderPass* This,
 void RenderPass_DrawIndexed(RenderPass* This,
                             uint32_t    indexCount,
                             uint32_t    instanceCount,
-                            uint32_t    firstVertex,
+                            uint32_t    firstIndex,
                             uint32_t    baseVertex,
                             uint32_t    firstInstance) {
-  This->encoder.DrawIndexed(indexCount, instanceCount, firstVertex, baseVertex, firstInstance);
+  This->encoder.DrawIndexed(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+}
+
+void RenderPass_DrawIndirect(RenderPass* This, Buffer* indirectBuffer, uint32_t indirectOffset) {
+  This->encoder.DrawIndirect(indirectBuffer->buffer, indirectOffset);
+  AddLease(This->leases.get(), indirectBuffer->lease);
+}
+
+void RenderPass_DrawIndexedIndirect(RenderPass* This,
+                                    Buffer*     indirectBuffer,
+                                    uint32_t    indirectOffset) {
+  This->encoder.DrawIndexedIndirect(indirectBuffer->buffer, indirectOffset);
+  AddLease(This->leases.get(), indirectBuffer->lease);
+}
+
+void RenderPass_ExecuteBundles(RenderPass* This, Array* bundles) {
+  std::vector<wgpu::RenderBundle> renderBundles;
+  for (uint32_t i = 0; i < bundles->length; ++i) {
+    auto bundle = static_cast<RenderBundle*>(static_cast<Object*>(bundles->ptr)[i].ptr);
+    if (bundle) {
+      renderBundles.push_back(bundle->bundle);
+      This->leases->insert(bundle->leases.begin(), bundle->leases.end());
+    }
+  }
+  This->encoder.ExecuteBundles(renderBundles.size(), renderBundles.data());
+  This->state->Reset();
 }
 
 void RenderPass_End(RenderPass* This) { This->encoder.End(); }
 
 void RenderPass_Destroy(RenderPass* This) { delete This; }
 
+RenderBundleEncoder* RenderBundleEncoder_RenderBundleEncoder(int     qualifiers,
+                                                             Type*   type,
+                                                             Device* device) {
+  assert(type->IsClass());
+  // The attachment formats come from the pipeline class, as they do for render pipelines.
+  PipelineLayout layout;
+  ExtractPipelineLayout(static_cast<ClassType*>(type), device, nullptr, &layout);
+  std::vector<wgpu::TextureFormat> colorFormats;
+  for (const auto& target : layout.colorTargets) { colorFormats.push_back(target.format); }
+  wgpu::RenderBundleEncoderDescriptor desc;
+  desc.colorFormatCount = colorFormats.size();
+  desc.colorFormats = colorFormats.data();
+  desc.depthStencilFormat = layout.depthStencilTarget.format;
+  return new RenderBundleEncoder(device->device.CreateRenderBundleEncoder(&desc),
+                                 GetBindingPlan(device->bindingPlans.get(), type));
+}
+
+void RenderBundleEncoder_Destroy(RenderBundleEncoder* This) { delete This; }
+
+void RenderBundleEncoder_SetPipeline(RenderBundleEncoder* This, RenderPipeline* pipeline) {
+  if (This->state.SetPipeline(pipeline->pipeline)) {
+    This->encoder.SetPipeline(pipeline->pipeline);
+  }
+}
+
+void RenderBundleEncoder_Set_T(RenderBundleEncoder* This, void* data) {
+  ApplyBindingPlan(*This->plan, This->encoder, &This->state, &This->leases, data, nullptr);
+}
+
+void RenderBundleEncoder_Set_T_uintArray(RenderBundleEncoder* This,
+                                         void*                data,
+                                         Array*               dynamicIndices) {
+  ApplyBindingPlan(*This->plan, This->encoder, &This->state, &This->leases, data,
+                   dynamicIndices);
+}
+
+void RenderBundleEncoder_Draw(RenderBundleEncoder* This,
+                              uint32_t             vertexCount,
+                              uint32_t             instanceCount,
+                              uint32_t             firstVertex,
+                              uint32_t             firstInstance) {
+  This->encoder.Draw(vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+void RenderBundleEncoder_DrawIndexed(RenderBundleEncoder* This,
+                                     uint32_t             indexCount,
+                                     uint32_t             instanceCount,
+                                     uint32_t             firstIndex,
+                                     uint32_t             baseVertex,
+                                     uint32_t             firstInstance) {
+  This->encoder.DrawIndexed(indexCount, instanceCount, firstIndex, baseVertex, firstInstance);
+}
+
+void RenderBundleEncoder_DrawIndirect(RenderBundleEncoder* This,
+                                      Buffer*              indirectBuffer,
+                                      uint32_t             indirectOffset) {
+  This->encoder.DrawIndirect(indirectBuffer->buffer, indirectOffset);
+  AddLease(&This->leases, indirectBuffer->lease);
+}
+
+void RenderBundleEncoder_DrawIndexedIndirect(RenderBundleEncoder* This,
+                                             Buffer*              indirectBuffer,
+                                             uint32_t             indirectOffset) {
+  This->encoder.DrawIndexedIndirect(indirectBuffer->buffer, indirectOffset);
+  AddLease(&This->leases, indirectBuffer->lease);
+}
+
+RenderBundle* RenderBundleEncoder_Finish(RenderBundleEncoder* This) {
+  wgpu::RenderBundleDescriptor desc;
+  return new RenderBundle(This->encoder.Finish(&desc), std::exchange(This->leases, Leases()));
+}
+
+void RenderBundle_Destroy(RenderBundle* This) { delete This; }
+
+static ComputePass* BeginComputePass(Type*                      type,
+                                     CommandEncoder*            encoder,
+                                     void*                      data,
+                                     wgpu::PassTimestampWrites* timestampWrites) {
+  auto                        plan = GetBindingPlan(encoder->bindingPlans.get(), type);
+  wgpu::ComputePassDescriptor desc;
+  desc.timestampWrites = timestampWrites;
+  auto result = new ComputePass(encoder->encoder.BeginComputePass(&desc), type,
+                                encoder->bindingPlans, plan, encoder->leases);
+  ApplyBindingPlan(*plan, result->encoder, result->state.get(), result->leases.get(), data,
+                   nullptr);
+  return result;
+}
+
 ComputePass* ComputePass_ComputePass_CommandEncoder_T(int             qualifiers,
                                                       Type*           type,
                                                       CommandEncoder* encoder,
                                                       void*           data) {
-  PipelineData pipelineData;
-  ExtractPipelineData(type, data, &pipelineData);
-  wgpu::ComputePassDescriptor desc;
-  auto                        passEncoder = encoder->encoder.BeginComputePass(&desc);
-  pipelineData.Set(passEncoder);
-  return new ComputePass(passEncoder, type);
+  return BeginComputePass(type, encoder, data, nullptr);
+}
+
+ComputePass* ComputePass_ComputePass_CommandEncoder_T_QuerySet_uint_uint(
+    int             qualifiers,
+    Type*           type,
+    CommandEncoder* encoder,
+    void*           data,
+    QuerySet*       querySet,
+    uint32_t        beginningOfPassWriteIndex,
+    uint32_t        endOfPassWriteIndex) {
+  if (!querySet->querySet) { return BeginComputePass(type, encoder, data, nullptr); }
+  wgpu::PassTimestampWrites timestampWrites;
+  timestampWrites.querySet = querySet->querySet;
+  timestampWrites.beginningOfPassWriteIndex = beginningOfPassWriteIndex;
+  timestampWrites.endOfPassWriteIndex = endOfPassWriteIndex;
+  return BeginComputePass(type, encoder, data, &timestampWrites);
+}
+
+ComputePass* ComputePass_ComputePass_CommandEncoder_T_GPUProfiler(int             qualifiers,
+                                                                  Type*           type,
+                                                                  CommandEncoder* encoder,
+                                                                  void*           data,
+                                                                  GPUProfiler*    profiler) {
+  wgpu::PassTimestampWrites timestampWrites;
+  bool                      timed = profiler->AllocatePass(&timestampWrites);
+  return BeginComputePass(type, encoder, data, timed ? &timestampWrites : nullptr);
 }
 
 ComputePass* ComputePass_ComputePass_ComputePass(int qualifiers, Type* type, ComputePass* parent) {
   assert(type->IsClass());
-  return new ComputePass(parent->encoder, static_cast<ClassType*>(type));
+  return new ComputePass(parent->encoder, type, parent->bindingPlans,
+                         GetBindingPlan(parent->bindingPlans.get(), type), parent->leases,
+                         parent->state);
 }
 
 void ComputePass_SetPipeline(ComputePass* This, ComputePipeline* pipeline) {
-  This->encoder.SetPipeline(pipeline->pipeline);
+  if (This->state->SetPipeline(pipeline->pipeline)) {
+    This->encoder.SetPipeline(pipeline->pipeline);
+  }
+}
+
+void ComputePass_Set_T(ComputePass* This, void* data) {
+  ApplyBindingPlan(*This->plan, This->encoder, This->state.get(), This->leases.get(), data,
+                   nullptr);
 }
 
-void ComputePass_Set(ComputePass* This, void* data) {
-  PipelineData pipelineData;
-  ExtractPipelineData(This->type, data, &pipelineData);
-  pipelineData.Set(This->encoder);
+void ComputePass_Set_T_uintArray(ComputePass* This, void* data, Array* dynamicIndices) {
+  ApplyBindingPlan(*This->plan, This->encoder, This->state.get(), This->leases.get(), data,
+                   dynamicIndices);
 }
 
+uint32_t ComputePass_GetCommandsIssued(ComputePass* This) { return This->state->issued; }
+
+uint32_t ComputePass_GetCommandsSkipped(ComputePass* This) { return This->state->skipped; }
+
 void ComputePass_Dispatch(ComputePass* This,
                           uint32_t     workgroupCountX,
                           uint32_t     workgroupCountY,
@@ -1387,27 +2962,51 @@ void ComputePass_Dispatch(ComputePass* This,
   This->encoder.DispatchWorkgroups(workgroupCountX, workgroupCountY, workgroupCountZ);
 }
 
+void ComputePass_DispatchIndirect(ComputePass* This,
+                                  Buffer*      indirectBuffer,
+                                  uint32_t     indirectOffset) {
+  This->encoder.DispatchWorkgroupsIndirect(indirectBuffer->buffer, indirectOffset);
+  AddLease(This->leases.get(), indirectBuffer->lease);
+}
+
 void ComputePass_End(ComputePass* This) { This->encoder.End(); }
 
 void ComputePass_Destroy(ComputePass* This) { delete This; }
 
 CommandBuffer* CommandEncoder_Finish(CommandEncoder* encoder) {
-  return new CommandBuffer(encoder->encoder.Finish());
+  return new CommandBuffer(encoder->encoder.Finish(), std::move(encoder->submitFlags),
+                           std::exchange(*encoder->leases, Leases()));
 }
 
 void CommandBuffer_Destroy(CommandBuffer* This) { delete This; }
 
+wgpu::Texture CreateOffscreenTexture(wgpu::Device        device,
+                                     wgpu::Extent3D      extent,
+                                     wgpu::TextureFormat format) {
+  wgpu::TextureDescriptor desc;
+  desc.usage = wgpu::TextureUsage::RenderAttachment | wgpu::TextureUsage::TextureBinding |
+               wgpu::TextureUsage::CopySrc;
+  desc.size = extent;
+  desc.format = format;
+  return device.CreateTexture(&desc);
+}
+
 Texture2D* SwapChain_GetCurrentTexture(SwapChain* swapChain) {
-  wgpu::SurfaceTexture surfaceTexture;
-  swapChain->surface.GetCurrentTexture(&surfaceTexture);
-  wgpu::Texture texture = surfaceTexture.texture;
+  wgpu::Texture texture = swapChain->offscreenTexture;
+  if (!texture) {
+    wgpu::SurfaceTexture surfaceTexture;
+    swapChain->surface.GetCurrentTexture(&surfaceTexture);
+    texture = surfaceTexture.texture;
+  }
 
-  return new Texture2D(texture, texture.CreateView());
+  return new Texture2D(swapChain->device, texture, texture.CreateView());
 }
 
-#ifndef __APPLE__
+#if !defined(__APPLE__) || defined(TOUCAN_HEADLESS)
 #ifndef __EMSCRIPTEN__
-void SwapChain_Present(SwapChain* swapChain) { swapChain->surface.Present(); }
+void SwapChain_Present(SwapChain* swapChain) {
+  if (swapChain->surface) { swapChain->surface.Present(); }
+}
 #endif
 
 void SwapChain_Destroy(SwapChain* This) { delete This; }
@@ -1415,6 +3014,12 @@ void SwapChain_Destroy(SwapChain* This) { delete This; }
 
 #ifndef __EMSCRIPTEN__
 void SwapChain_Resize(SwapChain* swapChain, const uint32_t* size) {
+  swapChain->extent = {size[0], size[1], 1};
+  if (swapChain->offscreenTexture) {
+    swapChain->offscreenTexture =
+        CreateOffscreenTexture(swapChain->device, swapChain->extent, swapChain->format);
+    return;
+  }
   wgpu::SurfaceConfiguration config;
   config.device = swapChain->device;
   config.format = swapChain->format;
@@ -1423,7 +3028,6 @@ void SwapChain_Resize(SwapChain* swapChain, const uint32_t* size) {
   config.presentMode = wgpu::PresentMode::Fifo;
 
   swapChain->surface.Configure(&config);
-  swapChain->extent = {size[0], size[1], 1};
 }
 #endif
 
@@ -1431,6 +3035,93 @@ float Math_rand() { return (float)(rand() % 100) / 100.0f; }
 
 void Math_Destroy(Math* This) {}
 
+// The quantizers below are simple per-component loops over contiguous arrays, written so
+// that the compiler can vectorize them.
+template <typename T>
+static void QuantizeVertices(Array* src, Array* dst, float scale, float min) {
+  auto     s = static_cast<const float*>(src->ptr);
+  auto     d = static_cast<T*>(dst->ptr);
+  uint32_t count = std::min(src->length, dst->length) * 4;
+  for (uint32_t i = 0; i < count; ++i) {
+    float v = std::clamp(s[i], min, 1.0f) * scale;
+    d[i] = static_cast<T>(v + (v < 0.0f ? -0.5f : 0.5f));
+  }
+}
+
+void VertexQuantizer_ToUnorm8x4(Array* src, Array* dst) {
+  QuantizeVertices<uint8_t>(src, dst, 255.0f, 0.0f);
+}
+
+void VertexQuantizer_ToSnorm8x4(Array* src, Array* dst) {
+  QuantizeVertices<int8_t>(src, dst, 127.0f, -1.0f);
+}
+
+void VertexQuantizer_ToUnorm16x4(Array* src, Array* dst) {
+  QuantizeVertices<uint16_t>(src, dst, 65535.0f, 0.0f);
+}
+
+void VertexQuantizer_ToSnorm16x4(Array* src, Array* dst) {
+  QuantizeVertices<int16_t>(src, dst, 32767.0f, -1.0f);
+}
+
+// Converts to IEEE half precision, rounding to nearest even.
+static toucan_half FloatToHalf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint32_t sign = (bits >> 16) & 0x8000;
+  uint32_t abs = bits & 0x7FFFFFFF;
+  if (abs >= 0x7F800000) {
+    // Infinity stays infinity; NaN stays a (quiet) NaN.
+    return sign | 0x7C00 | (abs > 0x7F800000 ? 0x0200 : 0);
+  }
+  if (abs >= 0x477FF000) {
+    // Rounds past the largest finite half.
+    return sign | 0x7C00;
+  }
+  if (abs >= 0x38800000) {
+    uint32_t result = (abs - 0x38000000) >> 13;
+    uint32_t rem = abs & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (result & 1))) { result++; }
+    return sign | result;
+  }
+  if (abs < 0x33000000) { return sign; }
+  // Denormal half: shift the mantissa, with its implicit one, into place.
+  uint32_t shift = 126 - (abs >> 23);
+  uint32_t mantissa = (abs & 0x7FFFFF) | 0x800000;
+  uint32_t result = mantissa >> shift;
+  uint32_t rem = mantissa & ((1u << shift) - 1);
+  uint32_t halfway = 1u << (shift - 1);
+  if (rem > halfway || (rem == halfway && (result & 1))) { result++; }
+  return sign | result;
+}
+
+void VertexQuantizer_ToFloat16x4(Array* src, Array* dst) {
+  auto     s = static_cast<const float*>(src->ptr);
+  auto     d = static_cast<toucan_half*>(dst->ptr);
+  uint32_t count = std::min(src->length, dst->length) * 4;
+  for (uint32_t i = 0; i < count; ++i) {
+    d[i] = FloatToHalf(s[i]);
+  }
+}
+
+void VertexQuantizer_ToUnorm10_10_10_2(Array* src, Array* dst) {
+  auto     s = static_cast<const float*>(src->ptr);
+  auto     d = static_cast<uint32_t*>(dst->ptr);
+  uint32_t count = std::min(src->length, dst->length);
+  for (uint32_t i = 0; i < count; ++i) {
+    const float* v = &s[i * 4];
+    uint32_t     r = static_cast<uint32_t>(std::clamp(v[0], 0.0f, 1.0f) * 1023.0f + 0.5f);
+    uint32_t     g = static_cast<uint32_t>(std::clamp(v[1], 0.0f, 1.0f) * 1023.0f + 0.5f);
+    uint32_t     b = static_cast<uint32_t>(std::clamp(v[2], 0.0f, 1.0f) * 1023.0f + 0.5f);
+    uint32_t     a = static_cast<uint32_t>(std::clamp(v[3], 0.0f, 1.0f) * 3.0f + 0.5f);
+    d[i] = r | (g << 10) | (b << 20) | (a << 30);
+  }
+}
+
+void VertexQuantizer_Destroy(VertexQuantizer* This) {}
+
+void Subgroup_Destroy(Subgroup* This) {}
+
 #if !(defined(__APPLE__) && TARGET_OS_IPHONE)
 void System_Print(Array* buffer) {
   fwrite(buffer->ptr, 1, buffer->length, stdout);
@@ -1478,6 +3169,16 @@ wgpu::Device CreateDawnDevice(wgpu::BackendType type, const wgpu::DeviceDescript
   wgpu::Adapter adapter;
   wgpu::RequestAdapterOptions adapterOptions;
   adapterOptions.backendType = type;
+  // TOUCAN_ADAPTER selects a software adapter, for machines without a GPU: "null" does no
+  // rendering at all, while "swiftshader" renders on the CPU.
+  if (const char* name = getenv("TOUCAN_ADAPTER")) {
+    if (!strcmp(name, "null")) {
+      adapterOptions.backendType = wgpu::BackendType::Null;
+    } else if (!strcmp(name, "swiftshader")) {
+      adapterOptions.backendType = wgpu::BackendType::Vulkan;
+      adapterOptions.forceFallbackAdapter = true;
+    }
+  }
   auto adapterFuture = gInstance.RequestAdapter(&adapterOptions, wgpu::CallbackMode::WaitAnyOnly,
       [&adapter](wgpu::RequestAdapterStatus status, wgpu::Adapter a, wgpu::StringView message) {
     adapter = a;
@@ -1486,8 +3187,43 @@ wgpu::Device CreateDawnDevice(wgpu::BackendType type, const wgpu::DeviceDescript
   if (gInstance.WaitAny(1, &aWaitInfo, UINT64_MAX) != wgpu::WaitStatus::Success) { return nullptr; }
   if (!adapter) return nullptr;
 
+  // Enable any optional features the adapter supports. Shaders which require
+  // a feature the device lacks are rejected at pipeline creation.
+  static constexpr auto kOptionalFeatures = std::array{
+    wgpu::FeatureName::Subgroups,
+    wgpu::FeatureName::ShaderF16,
+    wgpu::FeatureName::TimestampQuery,
+  };
+  std::vector<wgpu::FeatureName> features(desc->requiredFeatures,
+                                          desc->requiredFeatures + desc->requiredFeatureCount);
+  for (auto feature : kOptionalFeatures) {
+    if (adapter.HasFeature(feature)) { features.push_back(feature); }
+  }
+  wgpu::DeviceDescriptor deviceDesc = *desc;
+  deviceDesc.requiredFeatureCount = features.size();
+  deviceDesc.requiredFeatures = features.data();
+
+#ifndef __EMSCRIPTEN__
+  // Back Dawn's blob cache with files on disk, so that backend shader and pipeline
+  // compilation results are reused across runs.
+  wgpu::DawnCacheDeviceDescriptor cacheDesc;
+  if (BlobCache* blobCache = GetBlobCache()) {
+    cacheDesc.loadDataFunction = [](const void* key, size_t keySize, void* value,
+                                    size_t valueSize, void* userdata) -> size_t {
+      return static_cast<BlobCache*>(userdata)->Load(key, keySize, value, valueSize);
+    };
+    cacheDesc.storeDataFunction = [](const void* key, size_t keySize, const void* value,
+                                     size_t valueSize, void* userdata) {
+      static_cast<BlobCache*>(userdata)->Store(key, keySize, value, valueSize);
+    };
+    cacheDesc.functionUserdata = blobCache;
+    cacheDesc.nextInChain = deviceDesc.nextInChain;
+    deviceDesc.nextInChain = &cacheDesc;
+  }
+#endif
+
   wgpu::Device device;
-  auto deviceFuture = adapter.RequestDevice(desc, wgpu::CallbackMode::WaitAnyOnly,
+  auto deviceFuture = adapter.RequestDevice(&deviceDesc, wgpu::CallbackMode::WaitAnyOnly,
       [&device](wgpu::RequestDeviceStatus status, wgpu::Device d, wgpu::StringView message) {
     device = d;
   });
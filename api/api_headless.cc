@@ -0,0 +1,111 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A platform layer for machines with no display, used in place of the windowing system when
+// building with HEADLESS. Windows are only a size, and swap chains render into offscreen
+// textures. System.IsRunning() returns true for TOUCAN_FRAME_COUNT frames (100 by default),
+// then reports the elapsed time, so that unmodified samples run as fixed-length benchmarks.
+// Use TOUCAN_ADAPTER to select a software adapter; see CreateDawnDevice().
+
+#include <api.h>  // generated by generate_bindings
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#include <webgpu/webgpu_cpp.h>
+
+#include "api_internal.h"
+
+namespace Toucan {
+
+namespace {
+constexpr uint32_t kDefaultFrameCount = 100;
+
+uint32_t GetFrameCount() {
+  if (const char* count = getenv("TOUCAN_FRAME_COUNT")) { return strtoul(count, nullptr, 10); }
+  return kDefaultFrameCount;
+}
+}  // namespace
+
+static uint32_t gScreenSize[2] = {1920, 1080};
+
+struct Window {
+  Window(const uint32_t sz[2]) { size[0] = sz[0]; size[1] = sz[1]; }
+  uint32_t size[2];
+};
+
+Window* Window_Window(const uint32_t* size, const int32_t* position) { return new Window(size); }
+
+const uint32_t* Window_GetSize(Window* This) { return This->size; }
+
+void Window_Destroy(Window* This) { delete This; }
+
+Device* Device_Device() {
+  wgpu::DeviceDescriptor desc;
+  desc.SetUncapturedErrorCallback(
+    [](const wgpu::Device&, wgpu::ErrorType type, wgpu::StringView message) {
+      fprintf(stderr, "WebGPU Error:\n%s\n", message.data);
+    }
+  );
+
+  wgpu::Device device = CreateDawnDevice(wgpu::BackendType::Undefined, &desc);
+  if (!device) { return nullptr; }
+  return new Device(device);
+}
+
+double System_GetCurrentTime() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration<double>(now).count();
+}
+
+bool System_IsRunning() {
+  static uint32_t frameCount = GetFrameCount();
+  static uint32_t frame = 0;
+  static double   startTime = System_GetCurrentTime();
+  if (frame < frameCount) {
+    frame++;
+    return true;
+  }
+  if (frame == frameCount) {
+    double elapsed = System_GetCurrentTime() - startTime;
+    fprintf(stderr, "%u frames in %.3f s (%.1f frames/s)\n", frameCount, elapsed,
+            elapsed > 0.0 ? frameCount / elapsed : 0.0);
+    frame++;
+  }
+  return false;
+}
+
+bool System_HasPendingEvents() { return false; }
+
+Event* System_GetNextEvent() {
+  Event* result = new Event();
+  result->type = EventType::Unknown;
+  return result;
+}
+
+const uint32_t* System_GetScreenSize() { return gScreenSize; }
+
+wgpu::TextureFormat GetPreferredPixelFormat() { return wgpu::TextureFormat::BGRA8Unorm; }
+
+SwapChain* SwapChain_SwapChain(int qualifiers, Type* format, Device* device, Window* window) {
+  wgpu::Extent3D      extent = {window->size[0], window->size[1], 1};
+  wgpu::TextureFormat dawnFormat = ToDawnTextureFormat(format);
+  auto result = new SwapChain(nullptr, device->device, extent, dawnFormat, nullptr);
+  result->offscreenTexture = CreateOffscreenTexture(device->device, extent, dawnFormat);
+  return result;
+}
+
+};  // namespace Toucan
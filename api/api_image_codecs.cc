@@ -17,7 +17,14 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <jpeglib.h>
 
@@ -30,7 +37,23 @@ struct Image {
   struct jpeg_decompress_struct cinfo;
   struct jpeg_error_mgr         jerr;
   uint32_t                      size[2];
+  uint32_t                      scaledSize[2];
   Object                        encodedImage;
+  uint32_t                      encodedLength;
+  J_COLOR_SPACE                 outColorSpace;
+  bool                          headerRead;
+  std::mutex                    decodeMutex;  // Serializes use of cinfo.
+  std::mutex                    pendingMutex;
+  std::condition_variable       pendingDone;
+  uint32_t                      pendingDecodes = 0;
+};
+
+struct DecodeRequest {
+  std::mutex              mutex;
+  std::condition_variable done;
+  bool                    ready = false;
+  bool                    result = false;
+  Object                  buffer;
 };
 
 namespace {
@@ -42,6 +65,110 @@ void AssertSupportedPixelFormat(Type* pixelFormat) {
   auto templateArgs = parent->GetTemplateArgs();
   assert(templateArgs.size() == 2);
 }
+
+// A fixed set of threads which run decodes posted by Image.DecodeAsync(), so that many images
+// can be decoded at once.
+class WorkerPool {
+ public:
+  WorkerPool() {
+    uint32_t count = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t i = 0; i < count; ++i) {
+      threads_.emplace_back([this]() { Run(); });
+    }
+  }
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      quit_ = true;
+    }
+    available_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+  void Post(std::function<void()> job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      jobs_.push_back(std::move(job));
+    }
+    available_.notify_one();
+  }
+
+ private:
+  void Run() {
+    for (;;) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      available_.wait(lock, [this]() { return quit_ || !jobs_.empty(); });
+      if (jobs_.empty()) { return; }
+      auto job = std::move(jobs_.front());
+      jobs_.pop_front();
+      lock.unlock();
+      job();
+    }
+  }
+  std::vector<std::thread>          threads_;
+  std::deque<std::function<void()>> jobs_;
+  std::mutex                        mutex_;
+  std::condition_variable           available_;
+  bool                              quit_ = false;
+};
+
+#if !defined(__EMSCRIPTEN__)
+WorkerPool* GetWorkerPool() {
+  static WorkerPool workerPool;
+  return &workerPool;
+}
+#endif
+
+// Reference counts are only ever modified on the calling thread, never by a worker.
+void ReleaseObject(Object* object) {
+  object->controlBlock->strongRefs--;
+  if (object->controlBlock->strongRefs == 0) { free(object->ptr); }
+  object->controlBlock->weakRefs--;
+  if (object->controlBlock->weakRefs == 0) { free(object->controlBlock); }
+}
+
+bool IsValidScale(uint32_t scale) { return scale == 1 || scale == 2 || scale == 4 || scale == 8; }
+
+void ReadHeader(Image* image) {
+  jpeg_mem_src(&image->cinfo, static_cast<unsigned char*>(image->encodedImage.ptr),
+               image->encodedLength);
+  jpeg_read_header(&image->cinfo, TRUE);
+  image->headerRead = true;
+}
+
+bool DecodeImage(Image* This, Array* dest, uint32_t bufferWidth, uint32_t scale) {
+  if (!IsValidScale(scale)) {
+    fprintf(stderr, "Image.Decode(): scale must be 1, 2, 4 or 8\n");
+    return false;
+  }
+  if (!This->headerRead) { ReadHeader(This); }
+  This->cinfo.out_color_space = This->outColorSpace;
+  This->cinfo.scale_num = 1;
+  This->cinfo.scale_denom = scale;
+  jpeg_calc_output_dimensions(&This->cinfo);
+  uint32_t width = This->cinfo.output_width;
+  uint32_t height = This->cinfo.output_height;
+  if (bufferWidth < width || dest->length < bufferWidth * (height - 1) + width) {
+    fprintf(stderr, "Image.Decode(): buffer is too small for a %ux%u image\n", width, height);
+    return false;
+  }
+
+  // Decode straight into the destination, as many scanlines per call as libjpeg will produce.
+  std::vector<JSAMPROW> rows(height);
+  uint32_t*             p = static_cast<uint32_t*>(dest->ptr);
+  for (uint32_t y = 0; y < height; ++y) {
+    rows[y] = reinterpret_cast<JSAMPROW>(p + y * bufferWidth);
+  }
+  jpeg_start_decompress(&This->cinfo);
+  while (This->cinfo.output_scanline < height) {
+    uint32_t y = This->cinfo.output_scanline;
+    jpeg_read_scanlines(&This->cinfo, &rows[y], height - y);
+  }
+  jpeg_finish_decompress(&This->cinfo);
+  This->headerRead = false;
+  return true;
+}
 }  // namespace
 
 Image* Image_Image(int qualifiers, Type* pixelFormat, Object* encodedImage) {
@@ -52,69 +179,109 @@ Image* Image_Image(int qualifiers, Type* pixelFormat, Object* encodedImage) {
   result->encodedImage = *encodedImage;
   result->encodedImage.controlBlock->strongRefs++;
   result->encodedImage.controlBlock->weakRefs++;
+  result->encodedLength = length;
   AssertSupportedPixelFormat(pixelFormat);
+  // libjpeg-turbo expands to four channels itself, including from greyscale, so decoding
+  // needs no per-pixel work of ours.
+  bool bgra = static_cast<ClassType*>(pixelFormat)->GetName() == "BGRA8unorm";
+  result->outColorSpace = bgra ? JCS_EXT_BGRA : JCS_EXT_RGBA;
   result->cinfo.err = jpeg_std_error(&result->jerr);
   jpeg_create_decompress(&result->cinfo);
-  jpeg_mem_src(&result->cinfo, static_cast<unsigned char*>(encodedImage->ptr), length);
-  jpeg_read_header(&result->cinfo, TRUE);
+  ReadHeader(result);
   result->size[0] = result->cinfo.image_width;
   result->size[1] = result->cinfo.image_height;
   return result;
 }
 
-const uint32_t* Image_GetSize(Image* This) { return This->size; }
+const uint32_t* Image_GetSize(Image* This, uint32_t scale) {
+  if (!IsValidScale(scale)) {
+    fprintf(stderr, "Image.GetSize(): scale must be 1, 2, 4 or 8\n");
+    This->scaledSize[0] = This->scaledSize[1] = 0;
+    return This->scaledSize;
+  }
+  // This matches the rounding of libjpeg's scaled IDCT output dimensions.
+  This->scaledSize[0] = (This->size[0] + scale - 1) / scale;
+  This->scaledSize[1] = (This->size[1] + scale - 1) / scale;
+  return This->scaledSize;
+}
 
-void Image_Decode(Image* This, Array* dest, uint32_t bufferWidth) {
-  jpeg_start_decompress(&This->cinfo);
-  uint32_t* p = static_cast<uint32_t*>(dest->ptr);
-
-  int        row_stride = This->cinfo.output_width * This->cinfo.output_components;
-  JSAMPARRAY scanline = (*This->cinfo.mem->alloc_sarray)(
-      reinterpret_cast<j_common_ptr>(&This->cinfo), JPOOL_IMAGE, row_stride, 1);
-  uint32_t rshift = 0;
-  uint32_t gshift = 8;
-  uint32_t bshift = 16;
-  if (static_cast<ClassType*>(This->pixelFormat)->GetName() == "BGRA8unorm") {
-    rshift = 16;
-    bshift = 0;
+void Image_Decode(Image* This, Array* dest, uint32_t bufferWidth, uint32_t scale) {
+  std::lock_guard<std::mutex> lock(This->decodeMutex);
+  DecodeImage(This, dest, bufferWidth, scale);
+}
+
+DecodeRequest* Image_DecodeAsync(Image*   This,
+                                 Object*  buffer,
+                                 uint32_t bufferWidth,
+                                 uint32_t scale) {
+  auto request = new DecodeRequest();
+  request->buffer = *buffer;
+  if (!buffer->ptr) {
+    request->ready = true;
+    return request;
   }
-  while (This->cinfo.output_scanline < This->cinfo.output_height) {
-    jpeg_read_scanlines(&This->cinfo, scanline, 1);
-    if (This->cinfo.output_components == 3) {
-      uint8_t* buf = scanline[0];
-      for (int x = 0; x < This->size[0]; x++) {
-        uint8_t r = *buf++;
-        uint8_t g = *buf++;
-        uint8_t b = *buf++;
-        p[x] = 0xFF000000 | r << rshift | g << gshift | b << bshift;
-      }
-    } else if (This->cinfo.output_components == 1) {
-      uint8_t* buf = scanline[0];
-      for (int x = 0; x < This->size[0]; x++) {
-        uint8_t r = *buf++;
-        p[x] = 0xFF000000 | r << rshift | r << gshift | r << bshift;
-      }
-    } else {
-      assert(!"unsupported jpeg component count");
-    }
-    p += bufferWidth;
+  request->buffer.controlBlock->strongRefs++;
+  request->buffer.controlBlock->weakRefs++;
+  {
+    std::lock_guard<std::mutex> lock(This->pendingMutex);
+    This->pendingDecodes++;
   }
-  jpeg_finish_decompress(&This->cinfo);
+  auto job = [This, request, bufferWidth, scale]() {
+    Array dest{request->buffer.ptr, request->buffer.controlBlock->arrayLength};
+    bool  result;
+    {
+      std::lock_guard<std::mutex> lock(This->decodeMutex);
+      result = DecodeImage(This, &dest, bufferWidth, scale);
+    }
+    {
+      std::lock_guard<std::mutex> lock(request->mutex);
+      request->ready = true;
+      request->result = result;
+      // Notify under the lock, since the request may be destroyed as soon as Wait() returns.
+      request->done.notify_all();
+    }
+    // This must be the job's last use of the Image, since it may be destroyed as soon as it runs.
+    std::lock_guard<std::mutex> lock(This->pendingMutex);
+    if (--This->pendingDecodes == 0) { This->pendingDone.notify_all(); }
+  };
+#if defined(__EMSCRIPTEN__)
+  job();
+#else
+  GetWorkerPool()->Post(job);
+#endif
+  return request;
 }
 
 void Image_Destroy(Image* This) {
   // FIXME: make wrappers create Toucan null for native null
   if (This == nullptr) return;
 
-  jpeg_destroy_decompress(&This->cinfo);
-  This->encodedImage.controlBlock->strongRefs--;
-  if (This->encodedImage.controlBlock->strongRefs == 0) {
-    free(This->encodedImage.ptr);
-  }
-  This->encodedImage.controlBlock->weakRefs--;
-  if (This->encodedImage.controlBlock->weakRefs == 0) {
-    free(This->encodedImage.controlBlock);
+  {
+    std::unique_lock<std::mutex> lock(This->pendingMutex);
+    This->pendingDone.wait(lock, [This]() { return This->pendingDecodes == 0; });
   }
+  jpeg_destroy_decompress(&This->cinfo);
+  ReleaseObject(&This->encodedImage);
+  delete This;
+}
+
+bool DecodeRequest_IsReady(DecodeRequest* This) {
+  std::lock_guard<std::mutex> lock(This->mutex);
+  return This->ready;
+}
+
+bool DecodeRequest_Wait(DecodeRequest* This) {
+  std::unique_lock<std::mutex> lock(This->mutex);
+  This->done.wait(lock, [This]() { return This->ready; });
+  return This->result;
+}
+
+void DecodeRequest_Destroy(DecodeRequest* This) {
+  if (This == nullptr) return;
+
+  // The buffer must outlive the decode, so wait for it before dropping the reference.
+  DecodeRequest_Wait(This);
+  if (This->buffer.ptr) { ReleaseObject(&This->buffer); }
   delete This;
 }
 
@@ -15,13 +15,37 @@
 #ifndef _APIINTERNAL_H
 #define _APIINTERNAL_H
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 #include <webgpu/webgpu_cpp.h>
 
+#include "mipmap_generator.h"
+
 namespace Toucan {
 
+class Type;
+struct Method;
+struct BindingPlan;
+
+// Binding plans for pass and render bundle classes. Shared with the command encoders and
+// passes which look plans up, since they may outlive the Device.
+using BindingPlanMap = std::unordered_map<Type*, std::shared_ptr<const BindingPlan>>;
+
 struct Device {
   Device(wgpu::Device d) : device(d) {}
   wgpu::Device device;
+
+  // Objects derived from shader methods and pipeline classes, reused across pipeline creation.
+  std::unordered_map<Method*, wgpu::ShaderModule>         shaderModules;
+  std::unordered_map<Type*, wgpu::PipelineLayout>         pipelineLayouts;
+  std::unordered_map<std::string, wgpu::RenderPipeline>   renderPipelines;
+  std::unordered_map<std::string, wgpu::ComputePipeline>  computePipelines;
+  uint32_t                                                cacheHits = 0;
+  uint32_t                                                cacheMisses = 0;
+  std::shared_ptr<BindingPlanMap> bindingPlans = std::make_shared<BindingPlanMap>();
+  std::shared_ptr<MipmapPipelineCache> mipmapPipelines = std::make_shared<MipmapPipelineCache>();
 };
 
 struct SwapChain {
@@ -32,11 +56,16 @@ struct SwapChain {
   wgpu::Extent3D      extent;
   wgpu::TextureFormat format;
   void*               pool;
+  wgpu::Texture       offscreenTexture;  // Rendered to instead of the surface, if set.
 };
 
 wgpu::TextureFormat GetPreferredPixelFormat();
 wgpu::TextureFormat ToDawnTextureFormat(Type* type);
+uint32_t BytesPerPixel(wgpu::TextureFormat format);
 wgpu::Device CreateDawnDevice(wgpu::BackendType type, const wgpu::DeviceDescriptor* desc);
+wgpu::Texture CreateOffscreenTexture(wgpu::Device        device,
+                                     wgpu::Extent3D      extent,
+                                     wgpu::TextureFormat format);
 
 }  // namespace Toucan
 #endif  // _APIINTERNAL_H
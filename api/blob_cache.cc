@@ -0,0 +1,186 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "blob_cache.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Toucan {
+
+namespace {
+
+// Bump this whenever the entry format changes, or when a change to code generation could
+// make previously cached blobs invalid. Entries from other versions are ignored.
+constexpr uint32_t kBlobCacheVersion = 1;
+constexpr uintmax_t kDefaultMaxSizeInBytes = 256 * 1024 * 1024;
+// Temporary files from other processes are only trimmed once they are this old, since a younger
+// one may still be being written. Older ones were left behind by a process which died mid-store.
+constexpr auto kTempFileGracePeriod = std::chrono::hours(1);
+
+struct EntryHeader {
+  uint32_t version;
+  uint32_t keySize;
+  uint64_t valueSize;
+};
+
+uint64_t HashKey(const void* key, size_t keySize) {
+  // 64-bit FNV-1a, which is stable across runs and platforms.
+  uint64_t       hash = 0xcbf29ce484222325ull;
+  const uint8_t* bytes = static_cast<const uint8_t*>(key);
+  for (size_t i = 0; i < keySize; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uintmax_t DefaultMaxSizeInBytes() {
+  if (const char* size = getenv("TOUCAN_CACHE_SIZE_MB")) {
+    char*              end;
+    unsigned long long megabytes = strtoull(size, &end, 10);
+    if (end != size && *end == '\0' && megabytes > 0) { return megabytes * 1024 * 1024; }
+  }
+  return kDefaultMaxSizeInBytes;
+}
+
+std::filesystem::path DefaultCacheDirectory() {
+  if (const char* dir = getenv("TOUCAN_CACHE_DIR")) { return dir; }
+  return {};
+}
+
+}  // namespace
+
+BlobCache::BlobCache(std::filesystem::path directory, uintmax_t maxSizeInBytes)
+    : directory_(directory), maxSizeInBytes_(maxSizeInBytes) {
+  std::random_device random;
+  tempTag_ = (uint64_t(random()) << 32) | random();
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+    if (entry.is_regular_file(ec)) { sizeInBytes_ += entry.file_size(ec); }
+  }
+}
+
+std::filesystem::path BlobCache::PathForKey(const void* key, size_t keySize) const {
+  char name[17];
+  snprintf(name, sizeof(name), "%016llx",
+           static_cast<unsigned long long>(HashKey(key, keySize)));
+  return directory_ / name;
+}
+
+size_t BlobCache::Load(const void* key, size_t keySize, void* value, size_t valueSize) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ifstream               file(PathForKey(key, keySize), std::ios::binary);
+  EntryHeader                 header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) { return 0; }
+  if (header.version != kBlobCacheVersion || header.keySize != keySize) { return 0; }
+  std::vector<char> storedKey(keySize);
+  if (!file.read(storedKey.data(), keySize) || memcmp(storedKey.data(), key, keySize) != 0) {
+    return 0;
+  }
+  if (value && valueSize >= header.valueSize) {
+    if (!file.read(static_cast<char*>(value), header.valueSize)) { return 0; }
+  }
+  return header.valueSize;
+}
+
+void BlobCache::Store(const void* key, size_t keySize, const void* value, size_t valueSize) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::error_code             ec;
+  std::filesystem::create_directories(directory_, ec);
+  if (ec) { return; }
+  auto path = PathForKey(key, keySize);
+  auto oldSize = std::filesystem::file_size(path, ec);
+  if (!ec) { sizeInBytes_ -= std::min(oldSize, sizeInBytes_); }
+  // Write to a temporary file and rename it, so a concurrent reader never sees a partial entry.
+  // The temporary name is unique to this store, so that processes writing the same key don't
+  // write to the same file.
+  char tempSuffix[40];
+  snprintf(tempSuffix, sizeof(tempSuffix), ".%s-%u.tmp", TempTag().c_str(), nextTempId_++);
+  auto          tempPath = path;
+  tempPath += tempSuffix;
+  std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+  EntryHeader   header = {kBlobCacheVersion, static_cast<uint32_t>(keySize), valueSize};
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(static_cast<const char*>(key), keySize);
+  file.write(static_cast<const char*>(value), valueSize);
+  file.close();
+  if (!file) {
+    std::filesystem::remove(tempPath, ec);
+    return;
+  }
+  std::filesystem::rename(tempPath, path, ec);
+  if (ec) { return; }
+  sizeInBytes_ += sizeof(header) + keySize + valueSize;
+  if (sizeInBytes_ > maxSizeInBytes_) { Trim(); }
+}
+
+std::string BlobCache::TempTag() const {
+  char tag[17];
+  snprintf(tag, sizeof(tag), "%016llx", static_cast<unsigned long long>(tempTag_));
+  return tag;
+}
+
+void BlobCache::Trim() {
+  struct Entry {
+    std::filesystem::path           path;
+    std::filesystem::file_time_type time;
+    uintmax_t                       size;
+  };
+  std::vector<Entry> entries;
+  std::error_code    ec;
+  std::string        tempTag = TempTag();
+  auto tempCutoff = std::filesystem::file_time_type::clock::now() - kTempFileGracePeriod;
+  sizeInBytes_ = 0;
+  for (const auto& entry : std::filesystem::directory_iterator(directory_, ec)) {
+    if (!entry.is_regular_file(ec)) { continue; }
+    uintmax_t size = entry.file_size(ec);
+    auto      time = entry.last_write_time(ec);
+    sizeInBytes_ += size;
+    // Leave another process's temporary file alone while it may still be renamed into place.
+    if (entry.path().extension() == ".tmp" &&
+        entry.path().filename().string().find(tempTag) == std::string::npos &&
+        time > tempCutoff) {
+      continue;
+    }
+    entries.push_back({entry.path(), time, size});
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.time < b.time; });
+  // Trim to three quarters of the limit, so that every store doesn't trigger a trim.
+  uintmax_t target = maxSizeInBytes_ / 4 * 3;
+  for (const auto& entry : entries) {
+    if (sizeInBytes_ <= target) { break; }
+    if (std::filesystem::remove(entry.path, ec)) { sizeInBytes_ -= entry.size; }
+  }
+}
+
+BlobCache* GetBlobCache() {
+  static std::unique_ptr<BlobCache> blobCache = []() -> std::unique_ptr<BlobCache> {
+    std::filesystem::path directory = DefaultCacheDirectory();
+    if (directory.empty()) { return nullptr; }
+    return std::make_unique<BlobCache>(directory, DefaultMaxSizeInBytes());
+  }();
+  return blobCache.get();
+}
+
+}  // namespace Toucan
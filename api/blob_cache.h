@@ -0,0 +1,57 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _API_BLOB_CACHE_H_
+#define _API_BLOB_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+namespace Toucan {
+
+// A directory of files backing Dawn's blob cache, so that compiled shaders and pipelines
+// survive across runs. Each entry is stored in a file named by a hash of its key. The file
+// holds the cache version, the full key (to reject hash collisions), and the value. When the
+// directory grows past its size limit, the least recently written entries are removed.
+class BlobCache {
+ public:
+  BlobCache(std::filesystem::path directory, uintmax_t maxSizeInBytes);
+  // Returns the size of the value stored for the key, or 0 if there is none. The value is
+  // copied out only if valueSize is large enough to hold it.
+  size_t Load(const void* key, size_t keySize, void* value, size_t valueSize);
+  void   Store(const void* key, size_t keySize, const void* value, size_t valueSize);
+
+ private:
+  std::filesystem::path PathForKey(const void* key, size_t keySize) const;
+  std::string           TempTag() const;
+  void                  Trim();
+
+  std::filesystem::path directory_;
+  uintmax_t             maxSizeInBytes_;
+  uintmax_t             sizeInBytes_ = 0;
+  uint64_t              tempTag_;
+  uint32_t              nextTempId_ = 0;
+  std::mutex            mutex_;
+};
+
+// Returns the process-wide cache, or nullptr if caching is off. The cache is opt-in: it is
+// stored in $TOUCAN_CACHE_DIR, and disabled if that is unset or empty. Its size limit is
+// $TOUCAN_CACHE_SIZE_MB megabytes if that is a positive number, otherwise 256 MB.
+BlobCache* GetBlobCache();
+
+}  // namespace Toucan
+#endif  // _API_BLOB_CACHE_H_
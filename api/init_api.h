@@ -13,5 +13,8 @@
 // limitations under the License.
 
 namespace Toucan {
+struct Method;
 extern bool exitOnAbort;
+// If set, called to generate a shader entry point's code the first time a pipeline needs it.
+extern void (*generateShader)(Method* method);
 };  // namespace Toucan
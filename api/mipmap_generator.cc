@@ -0,0 +1,345 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mipmap_generator.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+
+namespace Toucan {
+
+namespace {
+
+// A single triangle covering the viewport. The instance index selects the destination slice of
+// a 3D texture.
+constexpr char kRenderShader[] = R"(
+struct VertexOut {
+  @builtin(position) position : vec4f,
+  @location(0) texCoord : vec2f,
+  @location(1) @interpolate(flat) slice : u32,
+};
+
+@vertex fn vs(@builtin(vertex_index) v : u32, @builtin(instance_index) i : u32) -> VertexOut {
+  let p = vec2f(f32((v << 1u) & 2u), f32(v & 2u));
+  var result : VertexOut;
+  result.position = vec4f(p * 2.0 - 1.0, 0.0, 1.0);
+  result.texCoord = vec2f(p.x, 1.0 - p.y);
+  result.slice = i;
+  return result;
+}
+)";
+
+constexpr char kRender2DShader[] = R"(
+@group(0) @binding(0) var s : sampler;
+@group(0) @binding(1) var src : texture_2d<f32>;
+
+@fragment fn fs(v : VertexOut) -> @location(0) vec4f {
+  return textureSampleLevel(src, s, v.texCoord, 0.0);
+}
+)";
+
+// Sampling halfway between source slices 2n and 2n + 1 averages them.
+constexpr char kRender3DShader[] = R"(
+@group(0) @binding(0) var s : sampler;
+@group(0) @binding(1) var src : texture_3d<f32>;
+
+@fragment fn fs(v : VertexOut) -> @location(0) vec4f {
+  let depth = f32(textureDimensions(src).z);
+  let w = (f32(v.slice) * 2.0 + 1.0) / depth;
+  return textureSampleLevel(src, s, vec3f(v.texCoord, w), 0.0);
+}
+)";
+
+// Unfilterable formats can't be sampled linearly, so they load and average the source texels.
+constexpr char kRenderLoad2DShader[] = R"(
+@group(0) @binding(1) var src : texture_2d<f32>;
+
+@fragment fn fs(v : VertexOut) -> @location(0) vec4f {
+  let id = vec2u(v.position.xy);
+  let last = textureDimensions(src) - 1u;
+  var sum = vec4f(0.0);
+  for (var i = 0u; i < 4u; i++) {
+    sum += textureLoad(src, min(id * 2u + vec2u(i & 1u, i >> 1u), last), 0);
+  }
+  return sum * 0.25;
+}
+)";
+
+constexpr char kRenderLoad3DShader[] = R"(
+@group(0) @binding(1) var src : texture_3d<f32>;
+
+@fragment fn fs(v : VertexOut) -> @location(0) vec4f {
+  let id = vec3u(vec2u(v.position.xy), v.slice);
+  let last = textureDimensions(src) - 1u;
+  var sum = vec4f(0.0);
+  for (var i = 0u; i < 8u; i++) {
+    sum += textureLoad(src, min(id * 2u + vec3u(i & 1u, (i >> 1u) & 1u, i >> 2u), last), 0);
+  }
+  return sum * 0.125;
+}
+)";
+
+constexpr char kCompute2DShader[] = R"(
+@group(0) @binding(0) var src : texture_2d<f32>;
+@group(0) @binding(1) var dst : texture_storage_2d<FORMAT, write>;
+
+@compute @workgroup_size(8, 8) fn main(@builtin(global_invocation_id) id : vec3u) {
+  if (any(id.xy >= textureDimensions(dst))) { return; }
+  let last = textureDimensions(src) - 1u;
+  var sum = vec4f(0.0);
+  for (var i = 0u; i < 4u; i++) {
+    sum += textureLoad(src, min(id.xy * 2u + vec2u(i & 1u, i >> 1u), last), 0);
+  }
+  textureStore(dst, id.xy, sum * 0.25);
+}
+)";
+
+constexpr char kCompute3DShader[] = R"(
+@group(0) @binding(0) var src : texture_3d<f32>;
+@group(0) @binding(1) var dst : texture_storage_3d<FORMAT, write>;
+
+@compute @workgroup_size(4, 4, 4) fn main(@builtin(global_invocation_id) id : vec3u) {
+  if (any(id >= textureDimensions(dst))) { return; }
+  let last = textureDimensions(src) - 1u;
+  var sum = vec4f(0.0);
+  for (var i = 0u; i < 8u; i++) {
+    sum += textureLoad(src, min(id * 2u + vec3u(i & 1u, (i >> 1u) & 1u, i >> 2u), last), 0);
+  }
+  textureStore(dst, id, sum * 0.125);
+}
+)";
+
+const char* StorageFormatName(wgpu::TextureFormat format) {
+  switch (format) {
+    case wgpu::TextureFormat::RGBA8Unorm: return "rgba8unorm";
+    case wgpu::TextureFormat::RGBA8Snorm: return "rgba8snorm";
+    case wgpu::TextureFormat::BGRA8Unorm: return "bgra8unorm";
+    case wgpu::TextureFormat::RGBA16Float: return "rgba16float";
+    case wgpu::TextureFormat::R32Float: return "r32float";
+    case wgpu::TextureFormat::RG32Float: return "rg32float";
+    case wgpu::TextureFormat::RGBA32Float: return "rgba32float";
+    default: return nullptr;
+  }
+}
+
+// 32-bit float formats are only filterable with an optional feature, which isn't requested.
+bool IsFilterable(wgpu::TextureFormat format) {
+  switch (format) {
+    case wgpu::TextureFormat::R32Float:
+    case wgpu::TextureFormat::RG32Float:
+    case wgpu::TextureFormat::RGBA32Float: return false;
+    default: return true;
+  }
+}
+
+wgpu::ShaderModule CreateShaderModule(wgpu::Device device, const std::string& code) {
+  wgpu::ShaderSourceWGSL wgslDesc;
+  wgslDesc.code = code.c_str();
+  wgpu::ShaderModuleDescriptor desc;
+  desc.nextInChain = &wgslDesc;
+  return device.CreateShaderModule(&desc);
+}
+
+void CreateRenderPipeline(wgpu::Device device, wgpu::Texture texture, MipmapPipelines* out) {
+  bool        is3D = texture.GetDimension() == wgpu::TextureDimension::e3D;
+  bool        filterable = IsFilterable(texture.GetFormat());
+  const char* fragmentShader = filterable ? (is3D ? kRender3DShader : kRender2DShader)
+                                          : (is3D ? kRenderLoad3DShader : kRenderLoad2DShader);
+  wgpu::ShaderModule module =
+      CreateShaderModule(device, std::string(kRenderShader) + fragmentShader);
+
+  wgpu::ColorTargetState colorTarget;
+  colorTarget.format = texture.GetFormat();
+  wgpu::FragmentState fragment;
+  fragment.module = module;
+  fragment.entryPoint = "fs";
+  fragment.targetCount = 1;
+  fragment.targets = &colorTarget;
+  wgpu::RenderPipelineDescriptor desc;
+  desc.vertex.module = module;
+  desc.vertex.entryPoint = "vs";
+  desc.fragment = &fragment;
+  if (!filterable) {
+    // An auto layout would ask for a filterable texture, so declare the source as unfilterable.
+    wgpu::BindGroupLayoutEntry entry;
+    entry.binding = 1;
+    entry.visibility = wgpu::ShaderStage::Fragment;
+    entry.texture.sampleType = wgpu::TextureSampleType::UnfilterableFloat;
+    entry.texture.viewDimension =
+        is3D ? wgpu::TextureViewDimension::e3D : wgpu::TextureViewDimension::e2D;
+    wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+    bindGroupLayoutDesc.entryCount = 1;
+    bindGroupLayoutDesc.entries = &entry;
+    wgpu::BindGroupLayout bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+    wgpu::PipelineLayoutDescriptor layoutDesc;
+    layoutDesc.bindGroupLayoutCount = 1;
+    layoutDesc.bindGroupLayouts = &bindGroupLayout;
+    desc.layout = device.CreatePipelineLayout(&layoutDesc);
+  }
+  out->renderPipeline = device.CreateRenderPipeline(&desc);
+
+  if (filterable) {
+    wgpu::SamplerDescriptor samplerDesc;
+    samplerDesc.magFilter = wgpu::FilterMode::Linear;
+    samplerDesc.minFilter = wgpu::FilterMode::Linear;
+    out->sampler = device.CreateSampler(&samplerDesc);
+  }
+}
+
+bool CreateComputePipeline(wgpu::Device device, wgpu::Texture texture, MipmapPipelines* out) {
+  const char* formatName = StorageFormatName(texture.GetFormat());
+  if (!formatName) { return false; }
+  bool        is3D = texture.GetDimension() == wgpu::TextureDimension::e3D;
+  std::string code = is3D ? kCompute3DShader : kCompute2DShader;
+  code.replace(code.find("FORMAT"), 6, formatName);
+
+  // The layout is explicit so that unfilterable formats can be read as well.
+  auto viewDimension = is3D ? wgpu::TextureViewDimension::e3D : wgpu::TextureViewDimension::e2D;
+  wgpu::BindGroupLayoutEntry entries[2];
+  entries[0].binding = 0;
+  entries[0].visibility = wgpu::ShaderStage::Compute;
+  entries[0].texture.sampleType = wgpu::TextureSampleType::UnfilterableFloat;
+  entries[0].texture.viewDimension = viewDimension;
+  entries[1].binding = 1;
+  entries[1].visibility = wgpu::ShaderStage::Compute;
+  entries[1].storageTexture.access = wgpu::StorageTextureAccess::WriteOnly;
+  entries[1].storageTexture.format = texture.GetFormat();
+  entries[1].storageTexture.viewDimension = viewDimension;
+  wgpu::BindGroupLayoutDescriptor bindGroupLayoutDesc;
+  bindGroupLayoutDesc.entryCount = 2;
+  bindGroupLayoutDesc.entries = entries;
+  wgpu::BindGroupLayout bindGroupLayout = device.CreateBindGroupLayout(&bindGroupLayoutDesc);
+  wgpu::PipelineLayoutDescriptor layoutDesc;
+  layoutDesc.bindGroupLayoutCount = 1;
+  layoutDesc.bindGroupLayouts = &bindGroupLayout;
+
+  wgpu::ComputePipelineDescriptor desc;
+  desc.layout = device.CreatePipelineLayout(&layoutDesc);
+  desc.compute.module = CreateShaderModule(device, code);
+  desc.compute.entryPoint = "main";
+  out->computePipeline = device.CreateComputePipeline(&desc);
+  return true;
+}
+
+const MipmapPipelines* GetPipelines(wgpu::Device         device,
+                                    MipmapPipelineCache* cache,
+                                    wgpu::Texture        texture,
+                                    bool                 compute) {
+  MipmapPipelineKey key(texture.GetFormat(), texture.GetDimension(), compute);
+  auto              i = cache->find(key);
+  if (i != cache->end()) { return &i->second; }
+  MipmapPipelines pipelines;
+  if (compute) {
+    if (!CreateComputePipeline(device, texture, &pipelines)) { return nullptr; }
+  } else {
+    CreateRenderPipeline(device, texture, &pipelines);
+  }
+  return &((*cache)[key] = pipelines);
+}
+
+wgpu::TextureView CreateLevelView(wgpu::Texture texture, uint32_t mipLevel, uint32_t layer) {
+  bool                        is3D = texture.GetDimension() == wgpu::TextureDimension::e3D;
+  wgpu::TextureViewDescriptor desc;
+  desc.format = texture.GetFormat();
+  desc.dimension = is3D ? wgpu::TextureViewDimension::e3D : wgpu::TextureViewDimension::e2D;
+  desc.baseMipLevel = mipLevel;
+  desc.mipLevelCount = 1;
+  desc.baseArrayLayer = layer;
+  desc.arrayLayerCount = 1;
+  return texture.CreateView(&desc);
+}
+
+}  // namespace
+
+void GenerateMipmaps(wgpu::Device         device,
+                     MipmapPipelineCache* cache,
+                     wgpu::CommandEncoder encoder,
+                     wgpu::Texture        texture) {
+  wgpu::TextureUsage usage = texture.GetUsage();
+  if (!(usage & wgpu::TextureUsage::TextureBinding)) {
+    fprintf(stderr, "GenerateMipmaps(): texture is not sampleable\n");
+    return;
+  }
+  bool compute = !(usage & wgpu::TextureUsage::RenderAttachment);
+  if (compute && !(usage & wgpu::TextureUsage::StorageBinding)) {
+    fprintf(stderr, "GenerateMipmaps(): texture must be renderable or storage\n");
+    return;
+  }
+  const MipmapPipelines* pipelines = GetPipelines(device, cache, texture, compute);
+  if (!pipelines) {
+    fprintf(stderr, "GenerateMipmaps(): texture format does not support storage\n");
+    return;
+  }
+
+  bool     is3D = texture.GetDimension() == wgpu::TextureDimension::e3D;
+  uint32_t layerCount = is3D ? 1 : texture.GetDepthOrArrayLayers();
+  for (uint32_t level = 1; level < texture.GetMipLevelCount(); ++level) {
+    uint32_t width = std::max(texture.GetWidth() >> level, 1u);
+    uint32_t height = std::max(texture.GetHeight() >> level, 1u);
+    uint32_t depth = is3D ? std::max(texture.GetDepthOrArrayLayers() >> level, 1u) : 1;
+    for (uint32_t layer = 0; layer < layerCount; ++layer) {
+      wgpu::BindGroupEntry      entries[2];
+      wgpu::TextureView         dst = CreateLevelView(texture, level, layer);
+      wgpu::BindGroupDescriptor bindGroupDesc;
+      if (compute) {
+        entries[0].binding = 0;
+        entries[0].textureView = CreateLevelView(texture, level - 1, layer);
+        entries[1].binding = 1;
+        entries[1].textureView = dst;
+        bindGroupDesc.entryCount = 2;
+        bindGroupDesc.entries = entries;
+        bindGroupDesc.layout = pipelines->computePipeline.GetBindGroupLayout(0);
+        wgpu::BindGroup          bindGroup = device.CreateBindGroup(&bindGroupDesc);
+        wgpu::ComputePassEncoder pass = encoder.BeginComputePass();
+        pass.SetPipeline(pipelines->computePipeline);
+        pass.SetBindGroup(0, bindGroup);
+        if (is3D) {
+          pass.DispatchWorkgroups((width + 3) / 4, (height + 3) / 4, (depth + 3) / 4);
+        } else {
+          pass.DispatchWorkgroups((width + 7) / 8, (height + 7) / 8, 1);
+        }
+        pass.End();
+      } else {
+        // Only the linearly filtered path has a sampler, at binding 0.
+        entries[0].binding = 0;
+        entries[0].sampler = pipelines->sampler;
+        entries[1].binding = 1;
+        entries[1].textureView = CreateLevelView(texture, level - 1, layer);
+        bindGroupDesc.entryCount = pipelines->sampler ? 2 : 1;
+        bindGroupDesc.entries = pipelines->sampler ? entries : &entries[1];
+        bindGroupDesc.layout = pipelines->renderPipeline.GetBindGroupLayout(0);
+        wgpu::BindGroup bindGroup = device.CreateBindGroup(&bindGroupDesc);
+        for (uint32_t slice = 0; slice < depth; ++slice) {
+          wgpu::RenderPassColorAttachment attachment;
+          attachment.view = dst;
+          if (is3D) { attachment.depthSlice = slice; }
+          attachment.loadOp = wgpu::LoadOp::Clear;
+          attachment.storeOp = wgpu::StoreOp::Store;
+          wgpu::RenderPassDescriptor passDesc;
+          passDesc.colorAttachmentCount = 1;
+          passDesc.colorAttachments = &attachment;
+          wgpu::RenderPassEncoder pass = encoder.BeginRenderPass(&passDesc);
+          pass.SetPipeline(pipelines->renderPipeline);
+          pass.SetBindGroup(0, bindGroup);
+          pass.Draw(3, 1, 0, slice);
+          pass.End();
+        }
+      }
+    }
+  }
+}
+
+}  // namespace Toucan
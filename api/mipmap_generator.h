@@ -0,0 +1,47 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _API_MIPMAP_GENERATOR_H_
+#define _API_MIPMAP_GENERATOR_H_
+
+#include <map>
+#include <tuple>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace Toucan {
+
+struct MipmapPipelines {
+  wgpu::RenderPipeline  renderPipeline;
+  wgpu::ComputePipeline computePipeline;
+  wgpu::Sampler         sampler;  // null for formats which aren't filterable
+};
+
+// Keyed by texture format, dimension and whether the compute path is used. Each Device owns one.
+using MipmapPipelineKey = std::tuple<wgpu::TextureFormat, wgpu::TextureDimension, bool>;
+using MipmapPipelineCache = std::map<MipmapPipelineKey, MipmapPipelines>;
+
+// Records commands which fill mip levels 1 and up of every layer of the texture by box-filtering
+// the level above. Renderable textures are downsampled with a render pass; storage textures with
+// a compute pass. Either way, the texture must also be sampleable. Array layers and cube faces
+// are filtered independently; 3D textures are filtered in depth as well. Formats which aren't
+// filterable are averaged with texel loads rather than a linear sampler. The pipelines are
+// created on first use and kept in the given cache.
+void GenerateMipmaps(wgpu::Device         device,
+                     MipmapPipelineCache* cache,
+                     wgpu::CommandEncoder encoder,
+                     wgpu::Texture        texture);
+
+}  // namespace Toucan
+#endif  // _API_MIPMAP_GENERATOR_H_
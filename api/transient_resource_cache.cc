@@ -0,0 +1,131 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "transient_resource_cache.h"
+
+#include <algorithm>
+
+#include "api_internal.h"
+
+namespace Toucan {
+
+namespace {
+
+uint64_t TextureSizeInBytes(wgpu::Texture texture) {
+  uint64_t size = 0;
+  uint32_t width = texture.GetWidth();
+  uint32_t height = texture.GetHeight();
+  uint32_t depth = texture.GetDepthOrArrayLayers();
+  bool     is3D = texture.GetDimension() == wgpu::TextureDimension::e3D;
+  for (uint32_t level = 0; level < texture.GetMipLevelCount(); ++level) {
+    uint64_t levelDepth = is3D ? std::max(depth >> level, 1u) : depth;
+    size += uint64_t(std::max(width >> level, 1u)) * std::max(height >> level, 1u) * levelDepth;
+  }
+  return size * BytesPerPixel(texture.GetFormat()) * texture.GetSampleCount();
+}
+
+}  // namespace
+
+TransientResourceCache::TransientResourceCache(uint64_t maxCachedBytes, uint32_t maxIdleFrames)
+    : maxCachedBytes_(maxCachedBytes), maxIdleFrames_(maxIdleFrames) {}
+
+TransientResourceCache::TextureKey TransientResourceCache::GetKey(
+    const wgpu::TextureDescriptor& desc) {
+  return {static_cast<WGPUTextureFormat>(desc.format),
+          static_cast<WGPUTextureDimension>(desc.dimension),
+          desc.size.width,
+          desc.size.height,
+          desc.size.depthOrArrayLayers,
+          desc.mipLevelCount,
+          desc.sampleCount,
+          static_cast<WGPUTextureUsage>(desc.usage)};
+}
+
+TransientResourceCache::TextureKey TransientResourceCache::GetKey(wgpu::Texture texture) {
+  return {static_cast<WGPUTextureFormat>(texture.GetFormat()),
+          static_cast<WGPUTextureDimension>(texture.GetDimension()),
+          texture.GetWidth(),
+          texture.GetHeight(),
+          texture.GetDepthOrArrayLayers(),
+          texture.GetMipLevelCount(),
+          texture.GetSampleCount(),
+          static_cast<WGPUTextureUsage>(texture.GetUsage())};
+}
+
+wgpu::Texture TransientResourceCache::AcquireTexture(wgpu::Device                   device,
+                                                     const wgpu::TextureDescriptor& desc) {
+  auto it = textures_.find(GetKey(desc));
+  if (it == textures_.end()) { return device.CreateTexture(&desc); }
+  wgpu::Texture texture = it->second->texture;
+  cachedBytes_ -= it->second->sizeInBytes;
+  entries_.erase(it->second);
+  textures_.erase(it);
+  return texture;
+}
+
+void TransientResourceCache::ReleaseTexture(wgpu::Texture texture) {
+  uint64_t size = TextureSizeInBytes(texture);
+  if (size > maxCachedBytes_) { return; }
+  Trim(maxCachedBytes_ - size, 0);
+  auto entry = entries_.insert(entries_.end(), Entry{size, frame_, texture});
+  entry->textureIt = textures_.insert({GetKey(texture), entry});
+  cachedBytes_ += size;
+}
+
+wgpu::Buffer TransientResourceCache::AcquireBuffer(wgpu::Device                  device,
+                                                   const wgpu::BufferDescriptor& desc) {
+  auto it = buffers_.find({desc.size, static_cast<WGPUBufferUsage>(desc.usage)});
+  if (it == buffers_.end()) { return device.CreateBuffer(&desc); }
+  wgpu::Buffer buffer = it->second->buffer;
+  cachedBytes_ -= it->second->sizeInBytes;
+  entries_.erase(it->second);
+  buffers_.erase(it);
+  return buffer;
+}
+
+void TransientResourceCache::ReleaseBuffer(wgpu::Buffer buffer) {
+  uint64_t size = buffer.GetSize();
+  if (size > maxCachedBytes_) { return; }
+  Trim(maxCachedBytes_ - size, 0);
+  BufferKey key = {size, static_cast<WGPUBufferUsage>(buffer.GetUsage())};
+  auto      entry = entries_.insert(entries_.end(), Entry{size, frame_, {}, buffer});
+  entry->bufferIt = buffers_.insert({key, entry});
+  cachedBytes_ += size;
+}
+
+void TransientResourceCache::NextFrame() {
+  frame_++;
+  if (frame_ > maxIdleFrames_) { Trim(maxCachedBytes_, frame_ - maxIdleFrames_); }
+}
+
+// Destroys every resource released before oldestFrame, then the least recently released ones
+// until no more than maxCachedBytes remain. Entries are in release order, so this stops at the
+// first one which is kept.
+void TransientResourceCache::Trim(uint64_t maxCachedBytes, uint32_t oldestFrame) {
+  while (!entries_.empty()) {
+    Entry& oldest = entries_.front();
+    if (cachedBytes_ <= maxCachedBytes && oldest.frame >= oldestFrame) { return; }
+    cachedBytes_ -= oldest.sizeInBytes;
+    if (oldest.texture) {
+      oldest.texture.Destroy();
+      textures_.erase(oldest.textureIt);
+    } else {
+      oldest.buffer.Destroy();
+      buffers_.erase(oldest.bufferIt);
+    }
+    entries_.pop_front();
+  }
+}
+
+}  // namespace Toucan
@@ -0,0 +1,75 @@
+// Copyright 2026 The Toucan Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _API_TRANSIENT_RESOURCE_CACHE_H_
+#define _API_TRANSIENT_RESOURCE_CACHE_H_
+
+#include <stdint.h>
+
+#include <list>
+#include <map>
+#include <tuple>
+
+#include <webgpu/webgpu_cpp.h>
+
+namespace Toucan {
+
+// Recycles textures and buffers which are recreated every frame, such as intermediate render
+// targets. Released resources are kept, keyed by their descriptor, and handed out again by a
+// matching Acquire. Resources idle for more than maxIdleFrames calls to NextFrame() are
+// destroyed, as are the least recently released ones whenever the total exceeds maxCachedBytes.
+// A recycled resource keeps its previous contents.
+class TransientResourceCache {
+ public:
+  TransientResourceCache(uint64_t maxCachedBytes, uint32_t maxIdleFrames);
+  wgpu::Texture AcquireTexture(wgpu::Device device, const wgpu::TextureDescriptor& desc);
+  void          ReleaseTexture(wgpu::Texture texture);
+  wgpu::Buffer  AcquireBuffer(wgpu::Device device, const wgpu::BufferDescriptor& desc);
+  void          ReleaseBuffer(wgpu::Buffer buffer);
+  void          NextFrame();
+  uint64_t      GetCachedBytes() const { return cachedBytes_; }
+
+ private:
+  using TextureKey = std::tuple<WGPUTextureFormat, WGPUTextureDimension, uint32_t, uint32_t,
+                                uint32_t, uint32_t, uint32_t, WGPUTextureUsage>;
+  using BufferKey = std::tuple<uint64_t, WGPUBufferUsage>;
+  // Cached resources are kept in a list in the order they were released, oldest first, so that
+  // Trim() only ever looks at the front. The maps find them by descriptor.
+  struct Entry;
+  using EntryList = std::list<Entry>;
+  using TextureMap = std::multimap<TextureKey, EntryList::iterator>;
+  using BufferMap = std::multimap<BufferKey, EntryList::iterator>;
+  struct Entry {
+    uint64_t             sizeInBytes;
+    uint32_t             frame;
+    wgpu::Texture        texture;  // exactly one of texture and buffer is set
+    wgpu::Buffer         buffer;
+    TextureMap::iterator textureIt;
+    BufferMap::iterator  bufferIt;
+  };
+  static TextureKey GetKey(const wgpu::TextureDescriptor& desc);
+  static TextureKey GetKey(wgpu::Texture texture);
+  void              Trim(uint64_t maxCachedBytes, uint32_t oldestFrame);
+
+  EntryList  entries_;
+  TextureMap textures_;
+  BufferMap  buffers_;
+  uint64_t   maxCachedBytes_;
+  uint32_t   maxIdleFrames_;
+  uint64_t   cachedBytes_ = 0;
+  uint32_t   frame_ = 0;
+};
+
+}  // namespace Toucan
+#endif  // _API_TRANSIENT_RESOURCE_CACHE_H_
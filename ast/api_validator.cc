@@ -24,14 +24,55 @@ namespace Toucan {
 
 namespace {
 
+int CountDynamicBuffers(ClassType* classType) {
+  int count = classType->GetParent() ? CountDynamicBuffers(classType->GetParent()) : 0;
+  for (const auto& field : classType->GetFields()) {
+    Type* type = field->type;
+    if (type->IsPtr()) { type = static_cast<PtrType*>(type)->GetBaseType(); }
+    int qualifiers;
+    type->GetUnqualifiedType(&qualifiers);
+    if (qualifiers & Type::Qualifier::Dynamic) { count++; }
+  }
+  return count;
+}
+
 bool IsValidVertexAttributeType(Type* type) {
   if (type->IsVector()) {
-    return IsValidVertexAttributeType(static_cast<VectorType*>(type)->GetElementType());
+    auto vectorType = static_cast<VectorType*>(type);
+    // Half-precision attributes only come in pairs and quads.
+    if (vectorType->GetElementType()->IsHalf()) { return vectorType->GetNumElements() != 3; }
+    return IsValidVertexAttributeType(vectorType->GetElementType());
   }
 
   return type->IsFloat() || type->IsInt() || type->IsUInt();
 }
 
+// Host-side types of the packed VertexFormats, which are only read through PackedVertexInput.
+bool IsValidPackedVertexAttributeType(Type* type) {
+  if (type->IsVector()) {
+    auto vectorType = static_cast<VectorType*>(type);
+    if (vectorType->GetNumElements() != 4) { return false; }
+    Type* elementType = vectorType->GetElementType();
+    return elementType->IsByte() || elementType->IsUByte() || elementType->IsShort() ||
+           elementType->IsUShort();
+  }
+  return false;
+}
+
+// The VertexFormat subclasses declared in api.t, each of which maps to a Dawn vertex format.
+bool IsPackedVertexFormat(Type* type) {
+  if (!type->IsClass()) return false;
+  auto classType = static_cast<ClassType*>(type);
+  auto parent = classType->GetParent();
+  if (!parent || parent->GetName() != "VertexFormat") return false;
+  static const char* const kFormats[] = {"Unorm8x4",  "Snorm8x4",  "Unorm16x4",
+                                         "Snorm16x4", "Float16x4", "Unorm10_10_10_2"};
+  for (const char* format : kFormats) {
+    if (classType->GetName() == format) return true;
+  }
+  return false;
+}
+
 bool IsValidRenderPipelineField(Type* type) {
   if (!type->IsStrongPtr()) return false;
 
@@ -42,6 +83,7 @@ bool IsValidRenderPipelineField(Type* type) {
   auto classType = static_cast<ClassType*>(type);
   auto templ = classType->GetTemplate();
   if (templ == NativeClass::VertexInput) return true;
+  if (templ == NativeClass::PackedVertexInput) return true;
   if (templ == NativeClass::Buffer) return qualifiers == Type::Qualifier::Index;
   if (templ == NativeClass::ColorOutput) return true;
   if (templ == NativeClass::DepthStencilOutput) return true;  // Ibid.
@@ -96,17 +138,28 @@ void APIValidator::ValidateType(Type* type, const FileLocation& fileLocation) {
 
   auto classType = static_cast<ClassType*>(type);
   auto classTemplate = classType->GetTemplate();
+  if ((qualifiers & Type::Qualifier::Instance) && classTemplate != NativeClass::VertexInput &&
+      classTemplate != NativeClass::PackedVertexInput) {
+    Error(classType, "instance qualifier is only valid on vertex inputs");
+  }
   if (classTemplate == NativeClass::None) return;
 
   if (classTemplate == NativeClass::Buffer) {
     ValidateBuffer(classType, qualifiers);
+  } else if (classTemplate == NativeClass::VertexInput) {
+    ValidateVertexInput(classType);
+  } else if (classTemplate == NativeClass::PackedVertexInput) {
+    ValidatePackedVertexInput(classType);
   } else if (classTemplate == NativeClass::BindGroup) {
     ValidateBindGroup(classType);
-  } else if (classTemplate == NativeClass::RenderPipeline) {
+  } else if (classTemplate == NativeClass::RenderPipeline ||
+             classTemplate == NativeClass::AsyncRenderPipeline) {
     ValidateRenderPipeline(classType);
-  } else if (classTemplate == NativeClass::RenderPass) {
+  } else if (classTemplate == NativeClass::RenderPass ||
+             classTemplate == NativeClass::RenderBundleEncoder) {
     ValidateRenderPipelineFields(classType);
-  } else if (classTemplate == NativeClass::ComputePipeline) {
+  } else if (classTemplate == NativeClass::ComputePipeline ||
+             classTemplate == NativeClass::AsyncComputePipeline) {
     ValidateComputePipeline(classType);
   } else if (classTemplate == NativeClass::ComputePass) {
     ValidateComputePipelineFields(classType);
@@ -114,7 +167,7 @@ void APIValidator::ValidateType(Type* type, const FileLocation& fileLocation) {
 }
 
 void APIValidator::ValidateVertexAttributeType(ClassType* buffer, Type* type) {
-  if (!IsValidVertexAttributeType(type)) {
+  if (!IsValidVertexAttributeType(type) && !IsValidPackedVertexAttributeType(type)) {
     Error(buffer, "%s is not a valid vertex attribute type", type->ToString().c_str());
   }
 }
@@ -146,6 +199,17 @@ void APIValidator::ValidateIndexBufferType(ClassType* buffer, Type* type) {
   }
 }
 
+void APIValidator::ValidateIndirectBufferType(ClassType* buffer, Type* type) {
+  if (!type->IsUnsizedArray()) {
+    Error(buffer, "%s is not a runtime-sized array", type->ToString().c_str());
+    return;
+  }
+  type = static_cast<ArrayType*>(type)->GetElementType();
+  if (!type->IsUInt()) {
+    Error(buffer, "%s is not a valid indirect buffer type; must be uint", type->ToString().c_str());
+  }
+}
+
 void APIValidator::ValidateUniformDataType(ClassType* buffer, Type* type) {
   if (type->IsClass()) {
     auto classType = static_cast<ClassType*>(type);
@@ -158,7 +222,7 @@ void APIValidator::ValidateUniformDataType(ClassType* buffer, Type* type) {
             type->ToString().c_str());
     }
     ValidateUniformDataType(buffer, static_cast<ArrayLikeType*>(type)->GetElementType());
-  } else if (!type->IsFloat() && !type->IsInt() && !type->IsUInt()) {
+  } else if (!type->IsHalf() && !type->IsFloat() && !type->IsInt() && !type->IsUInt()) {
     Error(buffer, "%s is not a valid uniform buffer type", type->ToString().c_str());
   }
 }
@@ -171,11 +235,32 @@ void APIValidator::ValidateStorageDataType(ClassType* buffer, Type* type) {
     }
   } else if (type->IsArrayLike()) {
     ValidateStorageDataType(buffer, static_cast<ArrayLikeType*>(type)->GetElementType());
-  } else if (!type->IsFloat() && !type->IsInt() && !type->IsUInt()) {
+  } else if (!type->IsHalf() && !type->IsFloat() && !type->IsInt() && !type->IsUInt()) {
     Error(buffer, "%s is not a valid storage buffer type", type->ToString().c_str());
   }
 }
 
+void APIValidator::ValidateVertexInput(ClassType* vertexInput) {
+  // Packed attribute types are valid in vertex buffers, but must be read via PackedVertexInput.
+  auto type = vertexInput->GetTemplateArgs()[0];
+  if (type->IsClass()) {
+    for (const auto& field : static_cast<ClassType*>(type)->GetFields()) {
+      if (!IsValidVertexAttributeType(field->type)) {
+        Error(vertexInput, "%s is not a valid vertex attribute type", field->type->ToString().c_str());
+      }
+    }
+  } else if (!IsValidVertexAttributeType(type)) {
+    Error(vertexInput, "%s is not a valid vertex attribute type", type->ToString().c_str());
+  }
+}
+
+void APIValidator::ValidatePackedVertexInput(ClassType* packedVertexInput) {
+  auto type = packedVertexInput->GetTemplateArgs()[0];
+  if (!IsPackedVertexFormat(type)) {
+    Error(packedVertexInput, "%s is not a packed vertex format", type->ToString().c_str());
+  }
+}
+
 void APIValidator::ValidateBuffer(ClassType* buffer, int qualifiers) {
   struct QualifierInfo {
     Type::Qualifier qualifier;
@@ -185,13 +270,22 @@ void APIValidator::ValidateBuffer(ClassType* buffer, int qualifiers) {
       Type::Qualifier::Sampleable,   "sampleable",  Type::Qualifier::Renderable, "renderable",
       Type::Qualifier::Unfilterable, "unfilterable"};
   int DeviceBufferQualifiers = Type::Qualifier::Vertex | Type::Qualifier::Index |
-                               Type::Qualifier::Uniform | Type::Qualifier::Storage;
+                               Type::Qualifier::Indirect | Type::Qualifier::Uniform |
+                               Type::Qualifier::Storage;
 
   auto type = buffer->GetTemplateArgs()[0];
   if (qualifiers & Type::Qualifier::Vertex) { ValidateVertexBufferType(buffer, type); }
   if (qualifiers & Type::Qualifier::Index) { ValidateIndexBufferType(buffer, type); }
+  if (qualifiers & Type::Qualifier::Indirect) { ValidateIndirectBufferType(buffer, type); }
   if (qualifiers & Type::Qualifier::Uniform) { ValidateUniformDataType(buffer, type); }
   if (qualifiers & Type::Qualifier::Storage) { ValidateStorageDataType(buffer, type); }
+  if (qualifiers & Type::Qualifier::Dynamic) {
+    if (!(qualifiers & (Type::Qualifier::Uniform | Type::Qualifier::Storage))) {
+      Error(buffer, "dynamic buffer must be uniform or storage");
+    } else if (type->IsUnsizedArray()) {
+      Error(buffer, "dynamic buffer can not be an unsized array");
+    }
+  }
   if (qualifiers & DeviceBufferQualifiers) {
     if (qualifiers & (Type::Qualifier::HostReadable | Type::Qualifier::HostWriteable)) {
       Error(buffer, "buffer can not have both host and device qualifiers");
@@ -214,6 +308,11 @@ void APIValidator::ValidateBindGroup(ClassType* bindGroup) {
       Error(bindGroup, "invalid bind group field type %s", field->type->ToString().c_str());
     }
   }
+  int dynamicBuffers = CountDynamicBuffers(classType);
+  if (dynamicBuffers > kMaxDynamicBuffersPerBindGroup) {
+    Error(bindGroup, "%d dynamic buffers exceeds the maximum of %d", dynamicBuffers,
+          kMaxDynamicBuffersPerBindGroup);
+  }
 }
 
 void APIValidator::ValidateRenderPipelineFields(ClassType* renderPipeline) {
@@ -30,9 +30,12 @@ class APIValidator {
   void ValidateVertexAttributeType(ClassType* buffer, Type* type);
   void ValidateVertexBufferType(ClassType* buffer, Type* type);
   void ValidateIndexBufferType(ClassType* buffer, Type* type);
+  void ValidateIndirectBufferType(ClassType* buffer, Type* type);
   void ValidateUniformDataType(ClassType* buffer, Type* type);
   void ValidateStorageDataType(ClassType* buffer, Type* type);
   void ValidateBuffer(ClassType* classType, int qualifiers);
+  void ValidateVertexInput(ClassType* vertexInput);
+  void ValidatePackedVertexInput(ClassType* packedVertexInput);
   void ValidateBindGroup(ClassType* classType);
   void ValidateRenderPipelineFields(ClassType* renderPipeline);
   void ValidateComputePipelineFields(ClassType* computePipeline);
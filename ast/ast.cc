@@ -304,6 +304,9 @@ DoubleConstant::DoubleConstant(double value) : value_(value) {}
 
 Type* DoubleConstant::GetType(TypeTable* types) { return types->GetDouble(); }
 
+SpecConstant::SpecConstant(ClassType* classType, std::string name, Expr* value)
+    : classType_(classType), name_(name), value_(value) {}
+
 BoolConstant::BoolConstant(bool value) : value_(value) {}
 
 Type* BoolConstant::GetType(TypeTable* types) { return types->GetBool(); }
@@ -500,6 +503,7 @@ Result VarExpr::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result LoadExpr::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result IncDecExpr::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result SliceExpr::Accept(Visitor* visitor) { return visitor->Visit(this); }
+Result SpecConstant::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result ZeroInitStmt::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result StoreStmt::Accept(Visitor* visitor) { return visitor->Visit(this); }
 Result WhileStatement::Accept(Visitor* visitor) { return visitor->Visit(this); }
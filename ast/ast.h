@@ -331,6 +331,24 @@ class DoubleConstant : public Expr {
   double value_;
 };
 
+// A class constant declared "override const". Shaders see it as a SPIR-V
+// specialization constant whose default is GetValue(); pipelines may replace it
+// at creation time. Host code always sees the default.
+class SpecConstant : public Expr {
+ public:
+  SpecConstant(ClassType* classType, std::string name, Expr* value);
+  Result      Accept(Visitor* visitor) override;
+  Type*       GetType(TypeTable* types) override { return value_->GetType(types); }
+  ClassType*  GetClassType() const { return classType_; }
+  std::string GetName() const { return name_; }
+  Expr*       GetValue() const { return value_; }
+
+ private:
+  ClassType*  classType_;
+  std::string name_;
+  Expr*       value_;
+};
+
 class CastExpr : public Expr {
  public:
   CastExpr(Type* type, Expr* expr);
@@ -892,10 +910,13 @@ class ConstDecl : public Stmt {
   Result      Accept(Visitor* visitor) override;
   std::string GetID() { return id_; }
   Expr*       GetExpr() { return expr_; }
+  bool        IsOverridable() const { return overridable_; }
+  void        SetOverridable(bool overridable) { overridable_ = overridable; }
 
  private:
   std::string id_;
   Expr*       expr_;
+  bool        overridable_ = false;
 };
 
 class VarDeclaration : public Stmt {
@@ -1204,6 +1225,7 @@ class Visitor {
   virtual Result Visit(VarExpr* node) { return Default(node); }
   virtual Result Visit(LoadExpr* node) { return Default(node); }
   virtual Result Visit(SliceExpr* node) { return Default(node); }
+  virtual Result Visit(SpecConstant* node) { return Default(node); }
   virtual Result Visit(StoreStmt* node) { return Default(node); }
   virtual Result Visit(SwizzleExpr* node) { return Default(node); }
   virtual Result Visit(ZeroInitStmt* node) { return Default(node); }
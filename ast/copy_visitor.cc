@@ -166,6 +166,10 @@ Result CopyVisitor::Visit(SliceExpr* node) {
   return Make<SliceExpr>(expr, start, end);
 }
 
+Result CopyVisitor::Visit(SpecConstant* node) {
+  return Make<SpecConstant>(node->GetClassType(), node->GetName(), node->GetValue());
+}
+
 Result CopyVisitor::Visit(SmartToRawPtr* node) {
   RESOLVE_OR_DIE(expr, node->GetExpr());
 
@@ -54,6 +54,7 @@ class CopyVisitor : public Visitor {
   Result        Visit(RawToSmartPtr* node) override;
   Result        Visit(SliceExpr* node) override;
   Result        Visit(SmartToRawPtr* node) override;
+  Result        Visit(SpecConstant* node) override;
   Result        Visit(Stmts* stmts) override;
   Result        Visit(StoreStmt* node) override;
   Result        Visit(SwizzleExpr* node) override;
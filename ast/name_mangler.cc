@@ -27,6 +27,9 @@ std::string QualifiersToString(int qualifiers, std::string sep) {
   if (qualifiers & Type::Qualifier::Storage) { result += "storage" + sep; }
   if (qualifiers & Type::Qualifier::Vertex) { result += "vertex" + sep; }
   if (qualifiers & Type::Qualifier::Index) { result += "index" + sep; }
+  if (qualifiers & Type::Qualifier::Indirect) { result += "indirect" + sep; }
+  if (qualifiers & Type::Qualifier::Dynamic) { result += "dynamic" + sep; }
+  if (qualifiers & Type::Qualifier::Instance) { result += "instance" + sep; }
   if (qualifiers & Type::Qualifier::Sampleable) { result += "sampleable" + sep; }
   if (qualifiers & Type::Qualifier::Renderable) { result += "renderable" + sep; }
   if (qualifiers & Type::Qualifier::ReadOnly) { result += "readonly" + sep; }
@@ -53,6 +56,10 @@ class ArgToString : public Visitor {
     result_ += node->GetTemplateDecl()->GetName();
     return {};
   }
+  Result Visit(ASTEnumType* node) override {
+    result_ += node->GetDecl()->GetName();
+    return {};
+  }
   Result Visit(ASTFormalTemplateArg* node) override {
     result_ += node->GetName();
     return {};
@@ -83,7 +90,7 @@ class ArgToString : public Visitor {
     return {};
   }
   Result Visit(ASTFloatingPointType* node) override {
-    result_ += node->GetBits() == 32 ? "float" : "double";
+    result_ += node->GetBits() == 16 ? "half" : node->GetBits() == 32 ? "float" : "double";
     return {};
   }
   Result Visit(ASTVectorType* node) override {
@@ -91,6 +98,11 @@ class ArgToString : public Visitor {
     result_ += std::to_string(node->GetNumComponents());
     return {};
   }
+  Result Visit(ASTArrayType* node) override {
+    node->GetElementType()->Accept(this);
+    result_ += "Array";
+    return {};
+  }
   Result Default(ASTNode* node) override {
     assert(!"unhandled node type in ArgToString visitor");
     return {};
@@ -29,6 +29,8 @@ void AddNativeClass(std::string name, NativeClass id) {
 
 void InitNativeClasses() {
   AddNativeClass("None", NativeClass::None);
+  AddNativeClass("AsyncComputePipeline", NativeClass::AsyncComputePipeline);
+  AddNativeClass("AsyncRenderPipeline", NativeClass::AsyncRenderPipeline);
   AddNativeClass("BindGroup", NativeClass::BindGroup);
   AddNativeClass("Buffer", NativeClass::Buffer);
   AddNativeClass("ColorOutput", NativeClass::ColorOutput);
@@ -36,12 +38,22 @@ void InitNativeClasses() {
   AddNativeClass("CommandEncoder", NativeClass::CommandEncoder);
   AddNativeClass("ComputePass", NativeClass::ComputePass);
   AddNativeClass("ComputePipeline", NativeClass::ComputePipeline);
+  AddNativeClass("DecodeRequest", NativeClass::DecodeRequest);
   AddNativeClass("DepthStencilOutput", NativeClass::DepthStencilOutput);
   AddNativeClass("Device", NativeClass::Device);
   AddNativeClass("Event", NativeClass::Event);
+  AddNativeClass("Fence", NativeClass::Fence);
+  AddNativeClass("GPUProfiler", NativeClass::GPUProfiler);
   AddNativeClass("Image", NativeClass::Image);
+  AddNativeClass("MapRequest", NativeClass::MapRequest);
   AddNativeClass("Math", NativeClass::Math);
+  AddNativeClass("PackedVertexInput", NativeClass::PackedVertexInput);
+  AddNativeClass("PipelineConstants", NativeClass::PipelineConstants);
+  AddNativeClass("QuerySet", NativeClass::QuerySet);
   AddNativeClass("Queue", NativeClass::Queue);
+  AddNativeClass("ReadbackRing", NativeClass::ReadbackRing);
+  AddNativeClass("RenderBundle", NativeClass::RenderBundle);
+  AddNativeClass("RenderBundleEncoder", NativeClass::RenderBundleEncoder);
   AddNativeClass("RenderPass", NativeClass::RenderPass);
   AddNativeClass("RenderPipeline", NativeClass::RenderPipeline);
   AddNativeClass("SampleableTexture1D", NativeClass::SampleableTexture1D);
@@ -50,6 +62,7 @@ void InitNativeClasses() {
   AddNativeClass("SampleableTexture3D", NativeClass::SampleableTexture3D);
   AddNativeClass("SampleableTextureCube", NativeClass::SampleableTextureCube);
   AddNativeClass("Sampler", NativeClass::Sampler);
+  AddNativeClass("Subgroup", NativeClass::Subgroup);
   AddNativeClass("SwapChain", NativeClass::SwapChain);
   AddNativeClass("System", NativeClass::System);
   AddNativeClass("Texture1D", NativeClass::Texture1D);
@@ -57,7 +70,9 @@ void InitNativeClasses() {
   AddNativeClass("Texture2DArray", NativeClass::Texture2DArray);
   AddNativeClass("Texture3D", NativeClass::Texture3D);
   AddNativeClass("TextureCube", NativeClass::TextureCube);
+  AddNativeClass("TransientPool", NativeClass::TransientPool);
   AddNativeClass("VertexInput", NativeClass::VertexInput);
+  AddNativeClass("VertexQuantizer", NativeClass::VertexQuantizer);
   AddNativeClass("Window", NativeClass::Window);
 }
 
@@ -23,6 +23,8 @@ namespace Toucan {
 
 enum class NativeClass {
   None,
+  AsyncComputePipeline,
+  AsyncRenderPipeline,
   BindGroup,
   Buffer,
   ColorOutput,
@@ -30,12 +32,22 @@ enum class NativeClass {
   CommandEncoder,
   ComputePass,
   ComputePipeline,
+  DecodeRequest,
   DepthStencilOutput,
   Device,
   Event,
+  Fence,
+  GPUProfiler,
   Image,
+  MapRequest,
   Math,
+  PackedVertexInput,
+  PipelineConstants,
+  QuerySet,
   Queue,
+  ReadbackRing,
+  RenderBundle,
+  RenderBundleEncoder,
   RenderPass,
   RenderPipeline,
   SampleableTexture1D,
@@ -44,6 +56,7 @@ enum class NativeClass {
   SampleableTexture3D,
   SampleableTextureCube,
   Sampler,
+  Subgroup,
   SwapChain,
   System,
   Texture1D,
@@ -51,11 +64,18 @@ enum class NativeClass {
   Texture2DArray,
   Texture3D,
   TextureCube,
+  TransientPool,
   VertexInput,
+  VertexQuantizer,
   Window,
 };
 
 NativeClass FindNativeClass(std::string className);
 
+// The most dynamic buffers a bind group may hold: the default
+// maxDynamicUniformBuffersPerPipelineLayout (8) plus maxDynamicStorageBuffersPerPipelineLayout (4).
+// The runtime stages dynamic offsets in fixed-size arrays of this length.
+constexpr int kMaxDynamicBuffersPerBindGroup = 8 + 4;
+
 };  // namespace Toucan
 #endif
@@ -369,6 +369,16 @@ Result SemanticPass::Visit(ConstDecl* decl) {
 
   if (scopeStack_.Top()->IsClassDecl()) {
     auto classDecl = static_cast<ClassDecl*>(scopeStack_.Top());
+    if (decl->IsOverridable()) {
+      Type* type = expr->GetType(types_);
+      if (!type->IsBool() && !type->IsInt() && !type->IsUInt() && !type->IsFloat()) {
+        return Error("overridable constant \"%s\" must be of bool, int, uint or float type",
+                     id.c_str());
+      }
+      auto classType = classDecl->GetClass();
+      classType->AddConstant(id, Make<SpecConstant>(classType, id, expr));
+      return {};
+    }
     classDecl->GetClass()->AddConstant(decl->GetID(), decl->GetExpr());
     return {};
   }
@@ -760,6 +770,8 @@ Result SemanticPass::Visit(UnresolvedStaticDot* node) {
 Expr* SemanticPass::MakeConstantOne(Type* type) {
   if (type->IsInteger()) {
     return Make<IntConstant>(1, static_cast<IntegerType*>(type)->GetBits());
+  } else if (type->IsHalf()) {
+    return Make<CastExpr>(type, Make<FloatConstant>(1.0f));
   } else if (type->IsFloat()) {
     return Make<FloatConstant>(1.0f);
   } else if (type->IsDouble()) {
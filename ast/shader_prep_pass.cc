@@ -161,6 +161,12 @@ Type* ShaderPrepPass::ConvertType(Type* type) {
       if (classType->GetTemplate() == NativeClass::VertexInput) {
         assert(classType->GetTemplateArgs().size() == 1);
         return classType->GetTemplateArgs()[0];
+      } else if (classType->GetTemplate() == NativeClass::PackedVertexInput) {
+        // The vertex fetch unpacks the attribute, so the shader sees only the device type.
+        // The API validator has checked that the argument is a VertexFormat.
+        type = classType->GetTemplateArgs()[0];
+        assert(type->IsClass());
+        return static_cast<ClassType*>(type)->FindType("DeviceType");
       } else if (classType->GetTemplate() == NativeClass::Buffer) {
         assert(classType->GetTemplateArgs().size() == 1);
         type = classType->GetTemplateArgs()[0];
@@ -208,7 +214,8 @@ void ShaderPrepPass::ExtractPipelineVars(ClassType* classType, VarVector* pipeli
     } else if (classType->GetTemplate() == NativeClass::DepthStencilOutput) {
       // Depth/stencil variables are inaccessible from device code.
       pipelineVars->push_back(nullptr);
-    } else if (classType->GetTemplate() == NativeClass::VertexInput) {
+    } else if (classType->GetTemplate() == NativeClass::VertexInput ||
+               classType->GetTemplate() == NativeClass::PackedVertexInput) {
       if (methodModifiers_ & Method::Modifier::Vertex) {
         auto input = std::make_shared<Var>(field->name, ConvertType(field->type));
         inputs_.push_back(input);
@@ -401,6 +408,7 @@ Result ShaderPrepPass::ResolveNativeMethodCall(MethodCall* node) {
     auto store = Make<StoreStmt>(Resolve(args[0]), Resolve(args[1]));
     return Make<ExprWithStmt>(nullptr, store);
   } else if (classType->GetTemplate() == NativeClass::VertexInput ||
+             classType->GetTemplate() == NativeClass::PackedVertexInput ||
              (classType->GetTemplate() == NativeClass::Buffer && method->name == "Get")) {
     return Make<LoadExpr>(Resolve(args[0]));
   } else if (classType->GetTemplate() == NativeClass::Buffer && (method->name == "Map" || method->name == "MapRead" || method->name == "MapWrite")) {
@@ -70,6 +70,8 @@ Result ShaderValidationPass::Visit(DoubleConstant* node) { return {}; }
  
 Result ShaderValidationPass::Visit(FloatConstant* node) { return {}; }
 
+Result ShaderValidationPass::Visit(SpecConstant* node) { return {}; }
+
 Result ShaderValidationPass::Visit(HeapAllocation* node) {
   Error(node, "\"new\" operator is prohibited in shader methods");
   return {};
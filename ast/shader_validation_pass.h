@@ -50,6 +50,7 @@ class ShaderValidationPass : public Visitor {
   Result            Visit(LoadExpr* node) override;
   Result            Visit(SmartToRawPtr* node) override;
   Result            Visit(SliceExpr* node) override;
+  Result            Visit(SpecConstant* node) override;
   Result            Visit(Stmts* stmts) override;
   Result            Visit(StoreStmt* node) override;
   Result            Visit(SwizzleExpr* node) override;
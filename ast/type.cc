@@ -26,7 +26,7 @@ namespace Toucan {
 namespace {
 
 constexpr int kNonRemovableQualifiers = Type::Qualifier::ReadOnly | Type::Qualifier::WriteOnly;
-constexpr int kNonAddableQualifiers = Type::Qualifier::Uniform | Type::Qualifier::Storage | Type::Qualifier::Vertex | Type::Qualifier::Index | Type::Qualifier::Sampleable | Type::Qualifier::Renderable | Type::Qualifier::HostReadable | Type::Qualifier::HostWriteable;
+constexpr int kNonAddableQualifiers = Type::Qualifier::Uniform | Type::Qualifier::Storage | Type::Qualifier::Vertex | Type::Qualifier::Index | Type::Qualifier::Indirect | Type::Qualifier::Dynamic | Type::Qualifier::Sampleable | Type::Qualifier::Renderable | Type::Qualifier::HostReadable | Type::Qualifier::HostWriteable;
 
 inline int roundUpTo(int modulus, int value) { return (value + modulus - 1) / modulus * modulus; }
 
@@ -36,6 +36,9 @@ std::string QualifiersToString(int qualifiers, std::string sep) {
   if (qualifiers & Type::Qualifier::Storage) { result += "storage" + sep; }
   if (qualifiers & Type::Qualifier::Vertex) { result += "vertex" + sep; }
   if (qualifiers & Type::Qualifier::Index) { result += "index" + sep; }
+  if (qualifiers & Type::Qualifier::Indirect) { result += "indirect" + sep; }
+  if (qualifiers & Type::Qualifier::Dynamic) { result += "dynamic" + sep; }
+  if (qualifiers & Type::Qualifier::Instance) { result += "instance" + sep; }
   if (qualifiers & Type::Qualifier::Sampleable) { result += "sampleable" + sep; }
   if (qualifiers & Type::Qualifier::Renderable) { result += "renderable" + sep; }
   if (qualifiers & Type::Qualifier::ReadOnly) { result += "readonly" + sep; }
@@ -111,6 +114,7 @@ bool FloatingPointType::CanNarrowTo(Type* other) const {
 
 std::string FloatingPointType::ToString() const {
   switch (bits_) {
+    case 16: return "half";
     case 32: return "float";
     case 64: return "double";
   }
@@ -588,6 +592,8 @@ IntegerType* TypeTable::GetInt() { return GetInteger(32, true); }
 
 IntegerType* TypeTable::GetUInt() { return GetInteger(32, false); }
 
+FloatingPointType* TypeTable::GetHalf() { return GetFloatingPoint(16); }
+
 FloatingPointType* TypeTable::GetFloat() { return GetFloatingPoint(32); }
 
 FloatingPointType* TypeTable::GetDouble() { return GetFloatingPoint(64); }
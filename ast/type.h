@@ -61,6 +61,7 @@ class Type {
   virtual bool  IsBoolVector() const { return false; }
   virtual bool  IsInt() const { return false; }
   virtual bool  IsUInt() const { return false; }
+  virtual bool  IsHalf() const { return false; }
   virtual bool  IsFloat() const { return false; }
   virtual bool  IsDouble() const { return false; }
   virtual bool  IsList() const { return false; }
@@ -100,6 +101,9 @@ class Type {
     HostWriteable = 0x200,
     Unfilterable = 0x0400,
     Coherent = 0x0800,
+    Indirect = 0x1000,
+    Dynamic = 0x2000,
+    Instance = 0x4000,
   };
 };
 
@@ -124,7 +128,7 @@ class VectorType : public ArrayLikeType {
   bool         IsVector() const override { return true; }
   bool         IsUnsigned() const override { return elementType_->IsUnsigned(); }
   bool         IsIntegerVector() const override { return elementType_->IsInteger(); }
-  bool         IsFloatVector() const override { return elementType_->IsFloat(); }
+  bool         IsFloatVector() const override { return elementType_->IsFloatingPoint(); }
   bool         IsBoolVector() const override { return elementType_->IsBool(); }
   bool         CanWidenTo(Type* type) const override;
   bool         CanNarrowTo(Type* type) const override;
@@ -180,6 +184,7 @@ class FloatingPointType : public Type {
   bool        CanWidenTo(Type* type) const override;
   bool        CanNarrowTo(Type* type) const override;
 
+  bool IsHalf() const override { return bits_ == 16; }
   bool IsFloat() const override { return bits_ == 32; }
   bool IsDouble() const override { return bits_ == 64; }
 
@@ -290,6 +295,8 @@ struct Method {
   std::string             wgsl;
   std::string             mangledName;
   int                     index = -1;
+  int                     shaderFeatures = 0;  // only used for shader entry points
+  std::vector<std::string> specConstants;      // "Class.name" of overridable constants, by SpecId
   enum Modifier {
     Static =     1<<0,
     DeviceOnly = 1<<1,
@@ -297,6 +304,10 @@ struct Method {
     Fragment =   1<<3,
     Compute =    1<<4
   };
+  enum ShaderFeature {
+    Subgroups =  1<<0,
+    ShaderF16 =  1<<1,
+  };
 };
 
 typedef std::vector<std::unique_ptr<Method>> MethodVector;
@@ -439,6 +450,7 @@ class TypeTable {
   IntegerType*       GetInt();
   IntegerType*       GetUInt();
   FloatingPointType* GetFloatingPoint(int bits);
+  FloatingPointType* GetHalf();
   FloatingPointType* GetFloat();
   FloatingPointType* GetDouble();
   VoidType*          GetVoid();
@@ -31,6 +31,9 @@ std::string QualifiersToString(int qualifiers, std::string sep) {
   if (qualifiers & Type::Qualifier::Storage) { result += "storage" + sep; }
   if (qualifiers & Type::Qualifier::Vertex) { result += "vertex" + sep; }
   if (qualifiers & Type::Qualifier::Index) { result += "index" + sep; }
+  if (qualifiers & Type::Qualifier::Indirect) { result += "indirect" + sep; }
+  if (qualifiers & Type::Qualifier::Dynamic) { result += "dynamic" + sep; }
+  if (qualifiers & Type::Qualifier::Instance) { result += "instance" + sep; }
   if (qualifiers & Type::Qualifier::Sampleable) { result += "sampleable" + sep; }
   if (qualifiers & Type::Qualifier::Renderable) { result += "renderable" + sep; }
   if (qualifiers & Type::Qualifier::ReadOnly) { result += "readonly" + sep; }
@@ -57,6 +60,10 @@ class ArgToString : public Visitor {
     result_ += node->GetTemplateDecl()->GetName();
     return {};
   }
+  Result Visit(ASTEnumType* node) override {
+    result_ += node->GetDecl()->GetName();
+    return {};
+  }
   Result Visit(ASTFormalTemplateArg* node) override {
     result_ += node->GetName();
     return {};
@@ -79,7 +86,7 @@ class ArgToString : public Visitor {
     return {};
   }
   Result Visit(ASTFloatingPointType* node) override {
-    result_ += node->GetBits() == 32 ? "float" : "double";
+    result_ += node->GetBits() == 16 ? "half" : node->GetBits() == 32 ? "float" : "double";
     return {};
   }
   Result Visit(ASTVectorType* node) override {
@@ -87,6 +94,11 @@ class ArgToString : public Visitor {
     result_ += std::to_string(node->GetNumComponents());
     return {};
   }
+  Result Visit(ASTArrayType* node) override {
+    node->GetElementType()->Accept(this);
+    result_ += "Array";
+    return {};
+  }
   Result Default(ASTNode* node) override {
     assert(!"unhandled node type in ArgToString visitor");
     return {};
@@ -115,7 +127,9 @@ void APIHeaderGenerator::Run() {
   header_ << "namespace Toucan {\n\n";
   header_ << "class ClassType;\n";
   header_ << "class Type;\n";
-  header_ << "using Deleter = void(*)(void*);\n\n";
+  header_ << "using Deleter = void(*)(void*);\n";
+  header_ << "// The bits of an IEEE 754 binary16 value; C++ has no portable half-precision type.\n";
+  header_ << "using toucan_half = uint16_t;\n\n";
   header_ << "struct ControlBlock {\n";
   header_ << "  uint32_t    strongRefs = 0;\n";
   header_ << "  uint32_t    weakRefs = 0;\n";
@@ -357,7 +371,9 @@ Result APIHeaderGenerator::Visit(ASTClassTemplateInstance* node) {
 }
 
 Result APIHeaderGenerator::Visit(ASTFloatingPointType* node) {
-  if (node->GetBits() == 32) {
+  if (node->GetBits() == 16) {
+    header_ << "toucan_half";
+  } else if (node->GetBits() == 32) {
     header_ << "float";
   } else if (node->GetBits() == 64) {
     header_ << "double";
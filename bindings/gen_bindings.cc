@@ -182,6 +182,16 @@ void GenBindings::EmitMethod(Method* method) {
     file_ << "};\n";
   }
   if (!method->wgsl.empty()) { file_ << "  m->wgsl = R\"(" << method->wgsl << ")\";\n"; }
+  if (method->shaderFeatures) {
+    file_ << "  m->shaderFeatures = " << method->shaderFeatures << ";\n";
+  }
+  if (!method->specConstants.empty()) {
+    file_ << "  m->specConstants = {";
+    for (const auto& name : method->specConstants) {
+      file_ << "\"" << name << "\", ";
+    }
+    file_ << "};\n";
+  }
 }
 
 void GenBindings::EmitClass(ClassType* classType) {
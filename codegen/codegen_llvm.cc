@@ -155,6 +155,7 @@ CodeGenLLVM::CodeGenLLVM(llvm::LLVMContext*                 context,
       debugOutput_(false) {
   boolType_ = llvm::Type::getInt1Ty(*context_);
   intType_ = llvm::Type::getInt32Ty(*context_);
+  halfType_ = llvm::Type::getHalfTy(*context_);
   floatType_ = llvm::Type::getFloatTy(*context_);
   doubleType_ = llvm::Type::getDoubleTy(*context_);
   byteType_ = llvm::Type::getInt8Ty(*context_);
@@ -182,18 +183,24 @@ void CodeGenLLVM::Run(Stmts* stmts) {
     pendingMethods_.pop_front();
     GenCodeForMethod(m);
   }
-  // Generate SPIR-V for shader entry points.
-  // An iterator can't be used here, since new types may be added (but won't need codegen).
-  int size = types_->GetTypes().size();
-  for (int i = 0; i < size; ++i) {
-    Type* type = types_->GetTypes()[i];
-    if (type->IsClass()) {
-      ClassType* classType = static_cast<ClassType*>(type);
-      for (const auto& method : classType->GetMethods()) {
-        if ((method->modifiers & (Method::Modifier::Vertex | Method::Modifier::Fragment | Method::Modifier::Compute)) != 0) {
-          GenCodeForMethod(method.get());
+  // In lazy mode, the runtime generates each shader when a pipeline first needs it.
+  if (lazyShaders_) { return; }
+  // Generate SPIR-V only for the shader entry points a pipeline constructed by this program
+  // would use: the most-derived entry point for each stage.
+  const int shaderStages =
+      Method::Modifier::Vertex | Method::Modifier::Fragment | Method::Modifier::Compute;
+  for (ClassType* classType : pipelineClasses_) {
+    int stagesFound = 0;
+    for (ClassType* c = classType; c != nullptr; c = c->GetParent()) {
+      int stagesFoundInClass = 0;
+      for (const auto& method : c->GetMethods()) {
+        int stage = method->modifiers & shaderStages;
+        if (stage && !(stage & stagesFound)) {
+          if (method->spirv.empty() && method->wgsl.empty()) { GenShaderForMethod(method.get()); }
+          stagesFoundInClass |= stage;
         }
       }
+      stagesFound |= stagesFoundInClass;
     }
   }
 }
@@ -266,6 +273,8 @@ llvm::Type* CodeGenLLVM::ConvertType(Type* type) {
     return shortType_;
   } else if (type->IsInt() || type->IsUInt()) {
     return intType_;
+  } else if (type->IsHalf()) {
+    return halfType_;
   } else if (type->IsFloat()) {
     return floatType_;
   } else if (type->IsDouble()) {
@@ -538,7 +547,7 @@ llvm::Intrinsic::ID CodeGenLLVM::FindIntrinsic(Method* method) {
     return llvm::Intrinsic::not_intrinsic;
   };
 
-  if (argType->IsFloat() || argType->IsFloatVector()) {
+  if (argType->IsFloatingPoint() || argType->IsFloatVector()) {
     if (auto id = findIntrinsic(method, floatIntrinsics)) return id;
   } else if (argType->IsBool() || argType->IsBoolVector()) {
     if (auto id = findIntrinsic(method, boolIntrinsics)) return id;
@@ -580,33 +589,39 @@ BuiltinCall CodeGenLLVM::FindBuiltin(Method* method) {
   return nullptr;
 }
 
+void CodeGenLLVM::GenShaderForMethod(Method* method) {
+  CodeGenSPIRV codeGenSPIRV(types_);
+  codeGenSPIRV.Run(method);
+  method->shaderFeatures = codeGenSPIRV.GetShaderFeatures();
+  method->specConstants = codeGenSPIRV.GetSpecConstants();
+  std::vector<uint32_t> spirv;
+  spirv = codeGenSPIRV.header();
+  spirv.insert(spirv.end(), codeGenSPIRV.annotations().begin(), codeGenSPIRV.annotations().end());
+  spirv.insert(spirv.end(), codeGenSPIRV.decl().begin(), codeGenSPIRV.decl().end());
+  spirv.insert(spirv.end(), codeGenSPIRV.GetBody().begin(), codeGenSPIRV.GetBody().end());
+
+  if (module_->getTargetTriple().isWasm()) {
+    tint::spirv::reader::Options spirvOptions;
+    tint::Result<tint::core::ir::Module>       ir = tint::spirv::reader::ReadIR(spirv, spirvOptions);
+    if (ir != tint::Success) {
+      std::cerr << "Tint SPIR-V reader failure:\n" << ir.Failure().reason << "\n";
+      return;
+    }
+    tint::wgsl::writer::Options wgslOptions;
+    auto                        result = tint::wgsl::writer::WgslFromIR(ir.Get(), wgslOptions);
+    if (result != tint::Success) {
+      std::cerr << "Tint WGSL writer failure:\n" << result.Failure() << "\n";
+      return;
+    }
+    method->wgsl = result.Get().wgsl;
+  } else {
+    method->spirv = spirv;
+  }
+}
+
 void CodeGenLLVM::GenCodeForMethod(Method* method) {
   if ((method->modifiers & (Method::Modifier::Vertex | Method::Modifier::Fragment | Method::Modifier::Compute)) != 0) {
-    CodeGenSPIRV codeGenSPIRV(types_);
-    codeGenSPIRV.Run(method);
-    std::vector<uint32_t> spirv;
-    spirv = codeGenSPIRV.header();
-    spirv.insert(spirv.end(), codeGenSPIRV.annotations().begin(), codeGenSPIRV.annotations().end());
-    spirv.insert(spirv.end(), codeGenSPIRV.decl().begin(), codeGenSPIRV.decl().end());
-    spirv.insert(spirv.end(), codeGenSPIRV.GetBody().begin(), codeGenSPIRV.GetBody().end());
-
-    if (module_->getTargetTriple().isWasm()) {
-      tint::spirv::reader::Options spirvOptions;
-      tint::Result<tint::core::ir::Module>       ir = tint::spirv::reader::ReadIR(spirv, spirvOptions);
-      if (ir != tint::Success) {
-        std::cerr << "Tint SPIR-V reader failure:\n" << ir.Failure().reason << "\n";
-        return;
-      }
-      tint::wgsl::writer::Options wgslOptions;
-      auto                        result = tint::wgsl::writer::WgslFromIR(ir.Get(), wgslOptions);
-      if (result != tint::Success) {
-        std::cerr << "Tint WGSL writer failure:\n" << result.Failure() << "\n";
-        return;
-      }
-      method->wgsl = result.Get().wgsl;
-    } else {
-      method->spirv = spirv;
-    }
+    GenShaderForMethod(method);
     return;
   }
   if (method->modifiers & Method::Modifier::DeviceOnly) { return; }
@@ -1122,6 +1137,8 @@ Result CodeGenLLVM::Visit(FloatConstant* node) {
   return llvm::ConstantFP::get(floatType_, node->GetValue());
 }
 
+Result CodeGenLLVM::Visit(SpecConstant* node) { return GenerateLLVM(node->GetValue()); }
+
 Result CodeGenLLVM::Visit(DoubleConstant* node) {
   return llvm::ConstantFP::get(doubleType_, node->GetValue());
 }
@@ -1466,6 +1483,16 @@ llvm::Value* CodeGenLLVM::GenerateMethodCall(Method*             method,
     for (Type* const& type : method->classType->GetTemplateArgs()) {
       args.push_back(CreateTypePtr(type));
     }
+    NativeClass nativeTemplate = method->classType->GetTemplate();
+    if (nativeTemplate == NativeClass::RenderPipeline ||
+        nativeTemplate == NativeClass::ComputePipeline ||
+        nativeTemplate == NativeClass::AsyncRenderPipeline ||
+        nativeTemplate == NativeClass::AsyncComputePipeline) {
+      Type* pipelineType = method->classType->GetTemplateArgs()[0];
+      if (pipelineType->IsClass()) {
+        pipelineClasses_.insert(static_cast<ClassType*>(pipelineType));
+      }
+    }
   }
   llvm::Intrinsic::ID intrinsic = function->getIntrinsicID();
   for (auto arg : argList->Get()) {
@@ -16,6 +16,7 @@
 #define _CODEGEN_CODEGEN_LLVM_H_
 
 #include <unordered_map>
+#include <unordered_set>
 
 #include <llvm/IR/IRBuilder.h>
 
@@ -136,6 +137,7 @@ class CodeGenLLVM : public Visitor {
   Result                Visit(ReturnStatement* stmt) override;
   Result                Visit(MethodCall* node) override;
   Result                Visit(SliceExpr* expr) override;
+  Result                Visit(SpecConstant* expr) override;
   Result                Visit(Stmts* stmts) override;
   Result                Visit(SwizzleExpr* stmts) override;
   Result                Visit(TempVarExpr* expr) override;
@@ -151,6 +153,8 @@ class CodeGenLLVM : public Visitor {
   }
   void               ICE(ASTNode* node);
   void               SetDebugOutput(bool debugOutput) { debugOutput_ = debugOutput; }
+  void               SetLazyShaders(bool lazyShaders) { lazyShaders_ = lazyShaders; }
+  void               GenShaderForMethod(Method* method);
   llvm::GlobalValue* GetTypeList() const { return typeList_; }
   const std::vector<Type*>& GetReferencedTypes() { return referencedTypes_; }
 
@@ -181,6 +185,7 @@ class CodeGenLLVM : public Visitor {
   llvm::legacy::FunctionPassManager*                    fpm_;
   DataVars                                              dataVars_;
   llvm::Type*                                           intType_;
+  llvm::Type*                                           halfType_;
   llvm::Type*                                           floatType_;
   llvm::Type*                                           doubleType_;
   llvm::Type*                                           boolType_;
@@ -205,6 +210,8 @@ class CodeGenLLVM : public Visitor {
   std::vector<Type*>                                    referencedTypes_;
   std::unordered_map<Type*, llvm::Value*>               typeMap_;
   std::list<Method*>                                    pendingMethods_;
+  std::unordered_set<ClassType*>                        pipelineClasses_;
+  bool                                                  lazyShaders_ = false;
 };
 
 };  // namespace Toucan
@@ -19,6 +19,7 @@
 #include <spirv/1.2/GLSL.std.450.h>
 #include <spirv/unified1/spirv.hpp>
 
+#include <ast/constant_folder.h>
 #include <ast/native_class.h>
 #include <ast/shader_prep_pass.h>
 
@@ -62,6 +63,53 @@ bool isMath(ClassType* classType) { return classType->GetNativeClass() == Native
 
 bool isSystem(ClassType* classType) { return classType->GetNativeClass() == NativeClass::System; }
 
+bool isSubgroup(ClassType* classType) {
+  return classType->GetNativeClass() == NativeClass::Subgroup;
+}
+
+bool containsHalf(Type* type) {
+  type = type->GetUnqualifiedType();
+  if (type->IsHalf()) {
+    return true;
+  } else if (type->IsArrayLike()) {
+    return containsHalf(static_cast<ArrayLikeType*>(type)->GetElementType());
+  } else if (type->IsClass()) {
+    for (auto c = static_cast<ClassType*>(type); c != nullptr; c = c->GetParent()) {
+      for (auto& field : c->GetFields()) {
+        if (containsHalf(field->type)) { return true; }
+      }
+    }
+  }
+  return false;
+}
+
+spv::Op subgroupArithmeticOpcode(const std::string& name, Type* type) {
+  if (type->IsVector()) { type = static_cast<VectorType*>(type)->GetElementType(); }
+  bool isFloat = type->IsFloatingPoint();
+  bool isUnsigned = type->IsUnsigned();
+  if (name == "Add" || name == "InclusiveAdd" || name == "ExclusiveAdd") {
+    return isFloat ? spv::OpGroupNonUniformFAdd : spv::OpGroupNonUniformIAdd;
+  } else if (name == "Min") {
+    return isFloat      ? spv::OpGroupNonUniformFMin
+           : isUnsigned ? spv::OpGroupNonUniformUMin
+                        : spv::OpGroupNonUniformSMin;
+  } else if (name == "Max") {
+    return isFloat      ? spv::OpGroupNonUniformFMax
+           : isUnsigned ? spv::OpGroupNonUniformUMax
+                        : spv::OpGroupNonUniformSMax;
+  }
+  return spv::OpNop;
+}
+
+spv::GroupOperation subgroupGroupOperation(const std::string& name) {
+  if (name == "InclusiveAdd") {
+    return spv::GroupOperationInclusiveScan;
+  } else if (name == "ExclusiveAdd") {
+    return spv::GroupOperationExclusiveScan;
+  }
+  return spv::GroupOperationReduce;
+}
+
 uint32_t builtinNameToID(const std::string& name) {
   if (name == "vertexIndex") {
     return spv::BuiltInVertexIndex;
@@ -104,7 +152,7 @@ spv::Op binOpToOpcode(BinOpNode::Op op,
                       Type*         rhsType,
                       uint32_t*     lhs,
                       uint32_t*     rhs) {
-  bool isFloat = lhsType->IsFloat() || lhsType->IsFloatVector();
+  bool isFloat = lhsType->IsFloatingPoint() || lhsType->IsFloatVector();
   bool isBool = lhsType->IsBool();
   switch (op) {
     case BinOpNode::ADD: return isFloat ? spv::OpFAdd : spv::OpIAdd;
@@ -192,6 +240,25 @@ void CodeGenSPIRV::DeclareBuiltInVars(const VarVector& builtInVars, Code* interf
   }
 }
 
+// Subgroup builtins are only declared when used, so that shaders which don't
+// use them don't require the GroupNonUniform capability.
+uint32_t CodeGenSPIRV::LoadSubgroupBuiltIn(uint32_t builtinId) {
+  Type*    type = types_->GetUInt();
+  uint32_t ptrId = subgroupBuiltIns_[builtinId];
+  if (ptrId == 0) {
+    uint32_t typeId = ConvertPointerToType(type, spv::StorageClassInput);
+    ptrId = AppendDecl(spv::Op::OpVariable, typeId, {spv::StorageClassInput});
+    Append(spv::OpDecorate, {ptrId, spv::DecorationBuiltIn, builtinId}, &annotations_);
+    subgroupBuiltIns_[builtinId] = ptrId;
+    lazyInterface_.push_back(ptrId);
+  }
+  return AppendCode(spv::Op::OpLoad, ConvertType(type), {ptrId});
+}
+
+void CodeGenSPIRV::RequireCapability(uint32_t capability) { capabilities_.insert(capability); }
+
+void CodeGenSPIRV::RequireExtension(const std::string& extension) { extensions_.insert(extension); }
+
 uint32_t CodeGenSPIRV::GetSampledImageType(Type* type) {
   auto t = sampledImageTypes_.find(type);
   if (t != sampledImageTypes_.end()) { return t->second; }
@@ -271,12 +338,21 @@ void CodeGenSPIRV::Run(Method* entryPoint) {
   Append(spv::OpCapability, {spv::CapabilityImageQuery}, &header_);
   Append(spv::OpCapability, {spv::CapabilitySampled1D}, &header_);
   Append(spv::OpCapability, {spv::CapabilityImage1D}, &header_);
+  for (uint32_t capability : capabilities_) {
+    Append(spv::OpCapability, {capability}, &header_);
+  }
+  for (const std::string& extension : extensions_) {
+    Code name;
+    AppendString(extension.c_str(), &name);
+    Append(spv::OpExtension, name, &header_);
+  }
   Code importName;
   AppendString("GLSL.std.450", &importName);
   header_.push_back(spv::OpExtInstImport | ((2 + importName.size()) << WordCountShift));
   header_.push_back(glslStd450Import_);
   header_.insert(header_.end(), importName.begin(), importName.end());
   Append(spv::OpMemoryModel, {spv::AddressingModelLogical, spv::MemoryModelGLSL450}, &header_);
+  interface.insert(interface.end(), lazyInterface_.begin(), lazyInterface_.end());
   uint32_t executionModel = toExecutionModel(methodModifiers_);
   AppendEntryPoint(executionModel, functionId, "main", interface);
   if (methodModifiers_ & Method::Modifier::Fragment) {
@@ -477,6 +553,10 @@ uint32_t CodeGenSPIRV::ConvertType(Type* type) {
     IntegerType* integerType = static_cast<IntegerType*>(type);
     resultId = AppendTypeDecl(spv::Op::OpTypeInt, {static_cast<uint32_t>(integerType->GetBits()),
                                                    integerType->Signed() ? 1u : 0u});
+  } else if (type->IsHalf()) {
+    shaderFeatures_ |= Method::ShaderFeature::ShaderF16;
+    RequireCapability(spv::CapabilityFloat16);
+    resultId = AppendTypeDecl(spv::Op::OpTypeFloat, {16});
   } else if (type->IsFloat()) {
     resultId = AppendTypeDecl(spv::Op::OpTypeFloat, {32});
   } else if (type->IsBool()) {
@@ -550,6 +630,26 @@ uint32_t CodeGenSPIRV::ConvertPointerToType(Type* type, uint32_t storageClass) {
   PtrTypeKey key(type->GetUnqualifiedType(), storageClass);
   if (spirvPtrTypes_[key] != 0) { return spirvPtrTypes_[key]; }
   uint32_t typeId = ConvertType(type);
+  // Float16 only covers function, private and workgroup variables; 16-bit values in buffers and
+  // shader interfaces need the optional 16-bit storage capabilities.
+  if (containsHalf(type)) {
+    switch (storageClass) {
+      case spv::StorageClassStorageBuffer:
+        RequireCapability(spv::CapabilityStorageBuffer16BitAccess);
+        RequireExtension("SPV_KHR_16bit_storage");
+        break;
+      case spv::StorageClassUniform:
+        RequireCapability(spv::CapabilityUniformAndStorageBuffer16BitAccess);
+        RequireExtension("SPV_KHR_16bit_storage");
+        break;
+      case spv::StorageClassInput:
+      case spv::StorageClassOutput:
+        RequireCapability(spv::CapabilityStorageInputOutput16);
+        RequireExtension("SPV_KHR_16bit_storage");
+        break;
+      default: break;
+    }
+  }
   uint32_t resultId = AppendTypeDecl(spv::Op::OpTypePointer, {storageClass, typeId});
   return spirvPtrTypes_[key] = resultId;
 }
@@ -584,7 +684,7 @@ Result CodeGenSPIRV::Visit(UnaryOp* node) {
   uint32_t rhs = GenerateSPIRV(node->GetRHS());
   Type*    rhsType = node->GetRHS()->GetType(types_);
   spv::Op  opCode = spv::OpNop;
-  bool     isFloat = rhsType->IsFloat() || rhsType->IsFloatVector();
+  bool     isFloat = rhsType->IsFloatingPoint() || rhsType->IsFloatVector();
   switch (node->GetOp()) {
     case UnaryOp::Op::Minus: opCode = isFloat ? spv::OpFNegate : spv::OpSNegate; break;
     case UnaryOp::Op::Negate: opCode = spv::OpLogicalNot; break;
@@ -603,13 +703,15 @@ uint32_t CodeGenSPIRV::CreateCast(Type*    srcType,
                                   uint32_t valueId) {
   if (dstType == srcType) {
     return valueId;
-  } else if (dstType->IsFloat() && srcType->IsInt()) {
+  } else if (dstType->IsFloatingPoint() && srcType->IsFloatingPoint()) {
+    return AppendCode(spv::Op::OpFConvert, resultType, {valueId});
+  } else if (dstType->IsFloatingPoint() && srcType->IsInt()) {
     return AppendCode(spv::Op::OpConvertSToF, resultType, {valueId});
-  } else if (dstType->IsInt() && srcType->IsFloat()) {
+  } else if (dstType->IsInt() && srcType->IsFloatingPoint()) {
     return AppendCode(spv::Op::OpConvertFToS, resultType, {valueId});
-  } else if (dstType->IsFloat() && srcType->IsUInt()) {
+  } else if (dstType->IsFloatingPoint() && srcType->IsUInt()) {
     return AppendCode(spv::Op::OpConvertUToF, resultType, {valueId});
-  } else if (dstType->IsUInt() && srcType->IsFloat()) {
+  } else if (dstType->IsUInt() && srcType->IsFloatingPoint()) {
     return AppendCode(spv::Op::OpConvertFToU, resultType, {valueId});
   } else if (dstType->IsInt() && srcType->IsUInt()) {
     return valueId;
@@ -709,7 +811,9 @@ uint32_t CodeGenSPIRV::GetBoolConstant(bool value) {
 }
 
 uint32_t CodeGenSPIRV::GetZeroConstant(Type* type) {
-  if (type->IsFloatingPoint()) {
+  if (type->IsHalf()) {
+    return GetConstant(type, 0);
+  } else if (type->IsFloatingPoint()) {
     return GetFloatConstant(0.0);
   } else if (type->IsInt()) {
     return GetIntConstant(0);
@@ -738,6 +842,28 @@ Result CodeGenSPIRV::Visit(FloatConstant* expr) {
   return GetFloatConstant(expr->GetValue());
 }
 
+Result CodeGenSPIRV::Visit(SpecConstant* node) {
+  SpecConstantKey key(node->GetClassType(), node->GetName());
+  if (auto id = specConstants_[key]) { return id; }
+  Type*    type = node->GetType(types_);
+  uint32_t resultType = ConvertType(type);
+  uint32_t value = 0;
+  ConstantFolder constantFolder(types_, &value);
+  constantFolder.Resolve(node->GetValue());
+  uint32_t resultId;
+  if (type->IsBool()) {
+    uint32_t op = value ? spv::Op::OpSpecConstantTrue : spv::Op::OpSpecConstantFalse;
+    resultId = AppendDecl(op, resultType, {});
+  } else {
+    resultId = AppendDecl(spv::Op::OpSpecConstant, resultType, {value});
+  }
+  uint32_t specId = specConstantNames_.size();
+  // Qualified by class, so that same-named constants of different classes stay distinct.
+  specConstantNames_.push_back(node->GetClassType()->ToString() + "." + node->GetName());
+  Append(spv::OpDecorate, {resultId, spv::DecorationSpecId, specId}, &annotations_);
+  return specConstants_[key] = resultId;
+}
+
 Result CodeGenSPIRV::Visit(ForStatement* forStmt) {
   Stmt* initStmt = forStmt->GetInitStmt();
   Expr* cond = forStmt->GetCond();
@@ -919,6 +1045,44 @@ Result CodeGenSPIRV::Visit(MethodCall* expr) {
     } else if (method->name == "GetSourceLine") {
       return GetUIntConstant(expr->GetFileLocation().lineNum);
     }
+  } else if (isSubgroup(method->classType)) {
+    shaderFeatures_ |= Method::ShaderFeature::Subgroups;
+    RequireCapability(spv::CapabilityGroupNonUniform);
+    if (method->name == "Size") {
+      return LoadSubgroupBuiltIn(spv::BuiltInSubgroupSize);
+    } else if (method->name == "InvocationId") {
+      return LoadSubgroupBuiltIn(spv::BuiltInSubgroupLocalInvocationId);
+    }
+    uint32_t resultType = ConvertType(expr->GetType(types_));
+    uint32_t scope = GetIntConstant(spv::ScopeSubgroup);
+    if (method->name == "Elect") {
+      return AppendCode(spv::Op::OpGroupNonUniformElect, resultType, {scope});
+    } else if (method->name == "Ballot") {
+      RequireCapability(spv::CapabilityGroupNonUniformBallot);
+      uint32_t predicate = GenerateSPIRV(args[0]);
+      return AppendCode(spv::Op::OpGroupNonUniformBallot, resultType, {scope, predicate});
+    } else if (method->name == "BroadcastFirst") {
+      RequireCapability(spv::CapabilityGroupNonUniformBallot);
+      uint32_t value = GenerateSPIRV(args[0]);
+      return AppendCode(spv::Op::OpGroupNonUniformBroadcastFirst, resultType, {scope, value});
+    } else if (method->name == "Broadcast" || method->name == "Shuffle") {
+      uint32_t value = GenerateSPIRV(args[0]);
+      uint32_t id = GenerateSPIRV(args[1]);
+      // SPIR-V 1.3 requires the Broadcast id to be a constant; fall back to a
+      // shuffle (which gives the same result for uniform ids) otherwise.
+      if (method->name == "Broadcast" && args[1]->IsConstant(types_)) {
+        RequireCapability(spv::CapabilityGroupNonUniformBallot);
+        return AppendCode(spv::Op::OpGroupNonUniformBroadcast, resultType, {scope, value, id});
+      }
+      RequireCapability(spv::CapabilityGroupNonUniformShuffle);
+      return AppendCode(spv::Op::OpGroupNonUniformShuffle, resultType, {scope, value, id});
+    } else if (auto opCode = subgroupArithmeticOpcode(method->name, args[0]->GetType(types_));
+               opCode != spv::OpNop) {
+      RequireCapability(spv::CapabilityGroupNonUniformArithmetic);
+      uint32_t value = GenerateSPIRV(args[0]);
+      uint32_t groupOp = subgroupGroupOperation(method->name);
+      return AppendCode(opCode, resultType, {scope, groupOp, value});
+    }
   }
   uint32_t functionId = functions_[method];
   if (functionId == 0) {
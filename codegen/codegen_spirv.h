@@ -16,6 +16,7 @@
 #define _CODEGEN_CODEGEN_SPIRV_H_
 
 #include <list>
+#include <set>
 #include <unordered_map>
 
 #include <ast/ast.h>
@@ -74,6 +75,7 @@ class CodeGenSPIRV : public Visitor {
   Result   Visit(BoolConstant* expr) override;
   Result   Visit(CastExpr* expr) override;
   Result   Visit(SmartToRawPtr* node) override;
+  Result   Visit(SpecConstant* node) override;
   Result   Visit(DestroyStmt* stmt) override;
   Result   Visit(DoStatement* stmt) override;
   Result   Visit(ExprStmt* exprStmt) override;
@@ -107,6 +109,8 @@ class CodeGenSPIRV : public Visitor {
   const Code& decl() const { return decl_; }
   const Code& GetBody() const { return body_; }
   TypeTable*  types() const { return types_; }
+  int         GetShaderFeatures() const { return shaderFeatures_; }
+  const std::vector<std::string>& GetSpecConstants() const { return specConstantNames_; }
 
  private:
   uint32_t DeclareVar(Var* var);
@@ -116,6 +120,9 @@ class CodeGenSPIRV : public Visitor {
   uint32_t CreateVectorSplat(uint32_t value, VectorType* type);
   uint32_t CreateCast(Type* srcType, Type* dstType, uint32_t resultType, uint32_t valueId);
   uint32_t GetSampledImageType(Type* imageType);
+  uint32_t LoadSubgroupBuiltIn(uint32_t builtinId);
+  void     RequireCapability(uint32_t capability);
+  void     RequireExtension(const std::string& extension);
 
   uint32_t                                     nextID_ = 1;
   uint32_t                                     glslStd450Import_;
@@ -138,6 +145,14 @@ class CodeGenSPIRV : public Visitor {
   std::list<Method*>                           pendingMethods_;
   BindGroupList                                bindGroups_;
   int                                          methodModifiers_;
+  int                                          shaderFeatures_ = 0;
+  std::set<uint32_t>                           capabilities_;
+  std::set<std::string>                        extensions_;
+  std::unordered_map<uint32_t, uint32_t>       subgroupBuiltIns_;
+  Code                                         lazyInterface_;
+  typedef std::pair<ClassType*, std::string>   SpecConstantKey;
+  std::unordered_map<SpecConstantKey, uint32_t> specConstants_;
+  std::vector<std::string>                     specConstantNames_;  // indexed by SpecId
 };
 
 };  // namespace Toucan
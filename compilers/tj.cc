@@ -68,6 +68,10 @@ double GetTimeUsec() {
 
 typedef void (*PFV)();
 
+CodeGenLLVM* gCodeGenLLVM = nullptr;
+
+void GenerateShader(Method* method) { gCodeGenLLVM->GenShaderForMethod(method); }
+
 void WriteCode(const std::vector<uint32_t>& code) {
   std::cout.write(reinterpret_cast<const char*>(code.data()), code.size() * 4);
 }
@@ -169,6 +173,9 @@ int main(int argc, char** argv) {
   fpm.add(llvm::createCFGSimplificationPass());
   CodeGenLLVM codeGenLLVM(&context, &types, module.get(), &builder, &fpm);
   codeGenLLVM.SetDebugOutput(dump);
+  codeGenLLVM.SetLazyShaders(true);
+  gCodeGenLLVM = &codeGenLLVM;
+  Toucan::generateShader = GenerateShader;
   std::string            errStr;
   llvm::ExecutionEngine* engine = llvm::EngineBuilder(std::move(module))
                                       .setEngineKind(llvm::EngineKind::JIT)
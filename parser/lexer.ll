@@ -102,6 +102,9 @@ enum    { return T_ENUM; }
 static  { return T_STATIC; }
 vertex  { return T_VERTEX; }
 index   { return T_INDEX; }
+indirect { return T_INDIRECT; }
+dynamic { return T_DYNAMIC; }
+instance { return T_INSTANCE; }
 fragment { return T_FRAGMENT; }
 compute { return T_COMPUTE; }
 uniform { return T_UNIFORM; }
@@ -118,6 +121,7 @@ hostwriteable { return T_HOSTWRITEABLE; }
 using   { return T_USING; }
 inline  { return T_INLINE; }
 unfilterable { return T_UNFILTERABLE; }
+override { return T_OVERRIDE; }
 
 int     { return T_INT; }
 uint    { return T_UINT; }
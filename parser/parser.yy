@@ -60,6 +60,7 @@ static MethodDecl* MakeMethodDecl(int modifiers, ArgList* optWorkgroupSize, std:
 static MethodDecl* MakeConstructor(int modifiers, ASTType* type, Stmts* formalArguments,
                                    Expr* initializer, Stmts* body);
 static MethodDecl* MakeDestructor(int modifiers, ASTType* type, Stmts* body);
+static Stmt* MakeOverridable(Stmt* constDecls);
 static void BeginBlock();
 static void EndBlock();
 static Expr* Load(Expr* expr);
@@ -138,8 +139,8 @@ static void DefineType(std::string id, ASTType* type) {
 %token T_INT T_UINT T_FLOAT T_DOUBLE T_BOOL T_BYTE T_UBYTE T_SHORT T_USHORT
 %token T_HALF
 %token T_STATIC T_VERTEX T_FRAGMENT T_COMPUTE T_THIS
-%token T_INDEX T_UNIFORM T_STORAGE T_SAMPLEABLE T_RENDERABLE
-%token T_USING T_INLINE T_UNFILTERABLE
+%token T_INDEX T_INDIRECT T_DYNAMIC T_INSTANCE T_UNIFORM T_STORAGE T_SAMPLEABLE T_RENDERABLE
+%token T_USING T_INLINE T_UNFILTERABLE T_OVERRIDE
 %right '=' T_ADD_EQUALS T_SUB_EQUALS T_MUL_EQUALS T_DIV_EQUALS
 %left T_LOGICAL_OR
 %left T_LOGICAL_AND
@@ -339,6 +340,7 @@ class_body_decl:
                                             { $$ = MakeDestructor($1, $3, $6); }
   | var_decl_statement ';'                  { $$ = $1; }
   | const_decl_statement ';'                { $$ = $1; }
+  | T_OVERRIDE const_decl_statement ';'     { $$ = MakeOverridable($2); }
   | enum_decl ';'                           { $$ = 0; }
   | using_decl                              { $$ = 0; }
   ;
@@ -378,6 +380,9 @@ type_qualifier:
   | T_STORAGE                               { $$ = Type::Qualifier::Storage; }
   | T_VERTEX                                { $$ = Type::Qualifier::Vertex; }
   | T_INDEX                                 { $$ = Type::Qualifier::Index; }
+  | T_INDIRECT                              { $$ = Type::Qualifier::Indirect; }
+  | T_DYNAMIC                               { $$ = Type::Qualifier::Dynamic; }
+  | T_INSTANCE                              { $$ = Type::Qualifier::Instance; }
   | T_SAMPLEABLE                            { $$ = Type::Qualifier::Sampleable; }
   | T_RENDERABLE                            { $$ = Type::Qualifier::Renderable; }
   | T_READONLY                              { $$ = Type::Qualifier::ReadOnly; }
@@ -424,6 +429,7 @@ scalar_type:
   | T_USHORT        { $$ = Make<ASTIntegerType>(16, false); }
   | T_BYTE          { $$ = Make<ASTIntegerType>(8, true); }
   | T_UBYTE         { $$ = Make<ASTIntegerType>(8, false); }
+  | T_HALF          { $$ = Make<ASTFloatingPointType>(16); }
   | T_FLOAT         { $$ = Make<ASTFloatingPointType>(32); }
   | T_DOUBLE        { $$ = Make<ASTFloatingPointType>(64); }
   | T_BOOL          { $$ = Make<ASTBoolType>(); }
@@ -834,6 +840,13 @@ static MethodDecl* MakeDestructor(int modifiers, ASTType* type, Stmts* body) {
                         nullptr, body);
 }
 
+static Stmt* MakeOverridable(Stmt* constDecls) {
+  for (auto decl : static_cast<Decls*>(constDecls)->Get()) {
+    static_cast<ConstDecl*>(decl)->SetOverridable(true);
+  }
+  return constDecls;
+}
+
 int ParseProgram(const char* filename,
                  NodeVector* nodes,
                  const std::vector<std::string>& includePaths,
@@ -45,11 +45,9 @@ var device = new Device();
 var image = new Image<RGBA8unorm>(inline("third_party/libjpeg-turbo/testimages/testorig.jpg"));
 var imageSize = image.GetSize();
 var texture = new sampleable Texture2D<RGBA8unorm>(device, imageSize);
-var buffer = new hostwriteable Buffer<[]ubyte<4>>(device, texture.MinBufferWidth() * imageSize.y);
-image.Decode(buffer.MapWrite(), texture.MinBufferWidth());
-var copyEncoder = new CommandEncoder(device);
-texture.CopyFromBuffer(copyEncoder, buffer, imageSize);
-device.GetQueue().Submit(copyEncoder.Finish());
+var pixels = [imageSize.x * imageSize.y] new ubyte<4>;
+image.Decode(pixels, imageSize.x);
+texture.Write(pixels, imageSize);
 
 var window = new Window(System.GetScreenSize());
 var swapChain = new SwapChain<PreferredPixelFormat>(device, window);
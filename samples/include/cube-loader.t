@@ -1,13 +1,27 @@
 class CubeLoader<PF> {
+  // Starts decoding a face on a worker thread.
   Load(data : *[]ubyte, face : uint) {
-    var image = new Image<PF>(data);
-    var size = image.GetSize();
-    var buffer = new hostwriteable Buffer<[]ubyte<4>>(device, texture.MinBufferWidth() * size.y);
-    image.Decode(buffer.MapWrite(), texture.MinBufferWidth());
-    var encoder = new CommandEncoder(device);
-    texture.CopyFromBuffer(encoder, buffer, size, face);
-    device.GetQueue().Submit(encoder.Finish());
+    images[face] = new Image<PF>(data);
+    var size = images[face].GetSize();
+    pixels[face] = [size.x * size.y] new ubyte<4>;
+    requests[face] = images[face].DecodeAsync(pixels[face], size.x);
   }
-  var device: *Device;
-  var texture: *TextureCube<PF>;
+  // Uploads the decoded faces. The texture is only handed out here, so that it can't be
+  // sampled before its faces are written.
+  Finish() : *sampleable renderable TextureCube<PF> {
+    for (var face = 0u; face < 6u; ++face) {
+      if (requests[face] != null && requests[face].Wait()) {
+        texture.Write(pixels[face], images[face].GetSize(), face);
+      }
+      requests[face] = null;
+      images[face] = null;
+      pixels[face] = null;
+    }
+    return texture;
+  }
+  var device : *Device;
+  var texture : *sampleable renderable TextureCube<PF>;
+  var images : [6]*Image<PF>;
+  var pixels : [6]*[]ubyte<4>;
+  var requests : [6]*DecodeRequest;
 }
@@ -12,11 +12,9 @@ var imageSize = image.GetSize();
 
 var mipCount = 30 - Math.clz(Math.max(imageSize.x, imageSize.y));
 var texture = new renderable sampleable Texture2D<RGBA8unorm>(device, imageSize, mipCount);
-var buffer = new hostwriteable Buffer<[]ubyte<4>>(device, texture.MinBufferWidth() * imageSize.y);
-image.Decode(buffer.MapWrite(), texture.MinBufferWidth());
-var copyEncoder = new CommandEncoder(device);
-texture.CopyFromBuffer(copyEncoder, buffer, imageSize);
-device.GetQueue().Submit(copyEncoder.Finish());
+var pixels = [imageSize.x * imageSize.y] new ubyte<4>;
+image.Decode(pixels, imageSize.x);
+texture.Write(pixels, imageSize);
 
 MipmapGenerator<RGBA8unorm>.Generate(device, texture);
 var window = new Window(System.GetScreenSize());
@@ -15,14 +15,16 @@ class Vertex {
 
 var device = new Device();
 
-var texture = new sampleable renderable TextureCube<RGBA8unorm>(device, {2176, 2176}, 12);
-var loader = CubeLoader<RGBA8unorm>{device, texture};
+var loader = CubeLoader<RGBA8unorm>{
+  device, new sampleable renderable TextureCube<RGBA8unorm>(device, {2176, 2176}, 12)
+};
 loader.Load(inline("third_party/home-cube/right.jpg"), 0);
 loader.Load(inline("third_party/home-cube/left.jpg"), 1);
 loader.Load(inline("third_party/home-cube/top.jpg"), 2);
 loader.Load(inline("third_party/home-cube/bottom.jpg"), 3);
 loader.Load(inline("third_party/home-cube/front.jpg"), 4);
 loader.Load(inline("third_party/home-cube/back.jpg"), 5);
+var texture = loader.Finish();
 
 MipmapGenerator<RGBA8unorm>.Generate(device, texture);
 
@@ -0,0 +1,47 @@
+#include "include/test.t"
+
+var device = new Device();
+var data = [4] new int;
+data[0] = 1;
+data[1] = 2;
+data[2] = 3;
+data[3] = 4;
+var buffer = new hostreadable Buffer<[]int>(device, data);
+data[1] = 20;
+data[2] = 30;
+data[3] = 40;
+buffer.SetRange(data, 1u, 2u);
+var result = buffer.MapRead();
+Test.Expect(result[0] == 1);
+Test.Expect(result[1] == 20);
+Test.Expect(result[2] == 30);
+Test.Expect(result[3] == 4);
+
+// Buffers whose size is not a whole number of 4-byte words keep their last bytes.
+var bytes = [7] new ubyte;
+for (var i = 0; i < 7; ++i) {
+  bytes[i] = (i + 1) as ubyte;
+}
+var byteBuffer = new hostreadable Buffer<[]ubyte>(device, bytes);
+var byteResult = byteBuffer.MapRead();
+Test.Expect(byteResult[4] == 5ub);
+Test.Expect(byteResult[6] == 7ub);
+byteResult = null;
+bytes[4] = 50ub;
+bytes[5] = 60ub;
+bytes[6] = 70ub;
+byteBuffer.SetRange(bytes, 4u, 3u);
+byteResult = byteBuffer.MapRead();
+Test.Expect(byteResult[3] == 4ub);
+Test.Expect(byteResult[4] == 50ub);
+Test.Expect(byteResult[5] == 60ub);
+Test.Expect(byteResult[6] == 70ub);
+
+// A range which starts inside a word is rejected, and leaves the buffer untouched.
+byteResult = null;
+bytes[5] = 61ub;
+byteBuffer.SetRange(bytes, 5u, 1u);
+byteResult = byteBuffer.MapRead();
+Test.Expect(byteResult[4] == 50ub);
+Test.Expect(byteResult[5] == 60ub);
+Test.Expect(byteResult[6] == 70ub);
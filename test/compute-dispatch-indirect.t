@@ -0,0 +1,38 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    buffer[cb.globalInvocationId.x] = 1;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+
+var storageBuf = new storage Buffer<[]int>(device, 4);
+var hostBuf = new hostreadable Buffer<[]int>(device, 4);
+var workgroupCounts = [3]uint{ 3, 1, 1 };
+var indirectBuf = new indirect Buffer<[]uint>(device, &workgroupCounts);
+
+var bg = new BindGroup<ComputeBindings>(device, {buffer = storageBuf});
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+computePass.SetPipeline(computePipeline);
+computePass.DispatchIndirect(indirectBuf, 0);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+var result = hostBuf.MapRead();
+Test.Expect(result[0] == 1);
+Test.Expect(result[1] == 1);
+Test.Expect(result[2] == 1);
+Test.Expect(result[3] == 0);
@@ -0,0 +1,48 @@
+#include "include/test.t"
+
+class Params {
+  var value : int;
+}
+
+class ComputeBindings {
+  var params : *dynamic uniform Buffer<Params>;
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    buffer[0] = bindings.Get().params.MapRead().value;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+
+var params = new dynamic uniform Buffer<Params>(device, 2);
+var p : Params;
+p.value = 21;
+params.SetElement(0u, &p);
+p.value = 42;
+params.SetElement(1u, &p);
+
+var storageBuf = new storage Buffer<[]int>(device, 1);
+var hostBuf = new hostreadable Buffer<[]int>(device, 1);
+
+var bg = new BindGroup<ComputeBindings>(device, {params = params, buffer = storageBuf});
+
+var indices = [1] new uint;
+indices[0] = 1u;
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+computePass.SetPipeline(computePipeline);
+computePass.Set({bindings = bg}, indices);
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+Test.Expect(hostBuf.MapRead()[0] == 42);
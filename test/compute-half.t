@@ -0,0 +1,43 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]float>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    // Only local variables are half, so no 16-bit storage capabilities are required.
+    var a = 2.0 as half;
+    var b = 0.5 as half;
+    var v = float<4>(1.0, 2.0, 3.0, 4.0) as half<4>;
+    buffer[0] = (a * b) as float;
+    buffer[1] = ((v + v) as float<4>).w;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+
+if (device.HasFeature(Feature.ShaderF16)) {
+  var storageBuf = new storage Buffer<[]float>(device, 2);
+  var hostBuf = new hostreadable Buffer<[]float>(device, 2);
+
+  var bg = new BindGroup<ComputeBindings>(device, {buffer = storageBuf});
+
+  var encoder = new CommandEncoder(device);
+  var computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+  computePass.SetPipeline(computePipeline);
+  computePass.Dispatch(1, 1, 1);
+  computePass.End();
+  hostBuf.CopyFromBuffer(encoder, storageBuf);
+  device.GetQueue().Submit(encoder.Finish());
+
+  var result = hostBuf.MapRead();
+  Test.Expect(result[0] == 1.0);
+  Test.Expect(result[1] == 8.0);
+} else {
+  Test.Expect(computePipeline == null);
+}
@@ -0,0 +1,59 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+// Same name as Compute.kValue, but a different constant.
+class Offset {
+  override const kValue = 0;
+}
+
+class Compute {
+  override const kValue = 7;
+  override const kNegate = false;
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    if (kNegate) {
+      buffer[0] = -kValue + Offset.kValue;
+    } else {
+      buffer[0] = kValue + Offset.kValue;
+    }
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var constants = new PipelineConstants();
+constants.Set("Compute.kValue", 42.0);
+constants.Set("Compute.kNegate", 1.0);
+constants.Set("Offset.kValue", 2.0);
+
+var defaultPipeline = new ComputePipeline<Compute>(device);
+var overriddenPipeline = new ComputePipeline<Compute>(device, constants);
+
+var storageBuf = new storage Buffer<[]int>(device, 1);
+var hostBuf = new hostreadable Buffer<[]int>(device, 1);
+
+var bg = new BindGroup<ComputeBindings>(device, {buffer = storageBuf});
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+computePass.SetPipeline(defaultPipeline);
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+Test.Expect(hostBuf.MapRead()[0] == 7);
+
+encoder = new CommandEncoder(device);
+computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+computePass.SetPipeline(overriddenPipeline);
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+hostBuf.CopyFromBuffer(encoder, storageBuf);
+device.GetQueue().Submit(encoder.Finish());
+
+Test.Expect(hostBuf.MapRead()[0] == -40);
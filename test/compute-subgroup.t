@@ -0,0 +1,44 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]uint>;
+}
+
+class Compute {
+  compute(64, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    var i = cb.globalInvocationId.x;
+    // Every invocation is active, so the sum of ones is the subgroup size, and the exclusive
+    // prefix sum of ones is the invocation's index within its subgroup.
+    buffer[i * 2u] = Subgroup.Add(1u) - Subgroup.Size();
+    buffer[i * 2u + 1u] = Subgroup.ExclusiveAdd(1u) - Subgroup.InvocationId();
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+
+if (device.HasFeature(Feature.Subgroups)) {
+  var storageBuf = new storage Buffer<[]uint>(device, 128);
+  var hostBuf = new hostreadable Buffer<[]uint>(device, 128);
+
+  var bg = new BindGroup<ComputeBindings>(device, {buffer = storageBuf});
+
+  var encoder = new CommandEncoder(device);
+  var computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+  computePass.SetPipeline(computePipeline);
+  computePass.Dispatch(1, 1, 1);
+  computePass.End();
+  hostBuf.CopyFromBuffer(encoder, storageBuf);
+  device.GetQueue().Submit(encoder.Finish());
+
+  var result = hostBuf.MapRead();
+  for (var i = 0; i < 128; ++i) {
+    Test.Expect(result[i] == 0u);
+  }
+} else {
+  // Pipelines whose shaders use subgroup operations are rejected on devices without them.
+  Test.Expect(computePipeline == null);
+}
@@ -17,3 +17,20 @@ class C {
 }
 new BindGroup<float>(device, null);
 new BindGroup<C>(device, {});
+
+class D {
+  var b0 : *dynamic uniform Buffer<float>;
+  var b1 : *dynamic uniform Buffer<float>;
+  var b2 : *dynamic uniform Buffer<float>;
+  var b3 : *dynamic uniform Buffer<float>;
+  var b4 : *dynamic uniform Buffer<float>;
+  var b5 : *dynamic uniform Buffer<float>;
+  var b6 : *dynamic uniform Buffer<float>;
+  var b7 : *dynamic uniform Buffer<float>;
+  var b8 : *dynamic uniform Buffer<float>;
+  var b9 : *dynamic uniform Buffer<float>;
+  var b10 : *dynamic uniform Buffer<float>;
+  var b11 : *dynamic uniform Buffer<float>;
+  var b12 : *dynamic uniform Buffer<float>;
+}
+new BindGroup<D>(device, {});
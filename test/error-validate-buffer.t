@@ -54,3 +54,8 @@ new hostwriteable storage Buffer<float>(device);
 new hostwriteable uniform Buffer<float>(device);
 
 new sampleable renderable readonly writeonly unfilterable Buffer<float>(device);
+
+new dynamic vertex Buffer<[]float>(device);
+new dynamic storage Buffer<[]float>(device);
+
+new instance vertex Buffer<[]float>(device);
@@ -0,0 +1,9 @@
+#include "api.t"
+
+class NotPacked : VertexFormat<float<4>, ubyte<4>> {}
+
+var device = new Device();
+var colors = new vertex Buffer<[]ubyte<4>>(device, 3);
+new PackedVertexInput<Unorm8x4>(colors); // should succeed
+new PackedVertexInput<RGBA8unorm>(colors);
+new PackedVertexInput<NotPacked>(colors);
@@ -0,0 +1,59 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    buffer[0] = 42;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+
+var storageBuf = new storage Buffer<[]int>(device, 1);
+
+var bg = new BindGroup<ComputeBindings>(device, {buffer = storageBuf});
+
+// Timestamps written directly into a query set.
+var querySet = new QuerySet(device, 2u);
+var timestamps = new storage Buffer<[]uint<2>>(device, 2);
+var readback = new hostreadable Buffer<[]uint<2>>(device, 2);
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {bindings = bg}, querySet, 0u, 1u);
+computePass.SetPipeline(computePipeline);
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+encoder.ResolveQuerySet(querySet, 0u, 2u, timestamps);
+readback.CopyFromBuffer(encoder, timestamps);
+device.GetQueue().Submit(encoder.Finish());
+if (querySet.IsSupported()) {
+  var t = readback.MapRead();
+  Test.Expect(t[1].y > t[0].y || (t[1].y == t[0].y && t[1].x >= t[0].x));
+}
+
+// Timestamps allocated and read back by a profiler.
+var profiler = new GPUProfiler(device);
+encoder = new CommandEncoder(device);
+computePass = new ComputePass<Compute>(encoder, {bindings = bg}, profiler);
+computePass.SetPipeline(computePipeline);
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+profiler.Resolve(encoder);
+device.GetQueue().Submit(encoder.Finish());
+profiler.Update();
+if (profiler.IsSupported()) {
+  for (var tries = 0; profiler.GetPassCount() == 0u && tries < 1000000; ++tries) {
+    profiler.Update();
+  }
+  Test.Assert(profiler.GetPassCount() == 1u);
+  Test.Expect(profiler.GetPassDuration(0u) >= 0.0);
+  Test.Expect(profiler.GetLatestFrame() == 0u);
+} else {
+  Test.Expect(profiler.GetPassCount() == 0u);
+}
@@ -0,0 +1,13 @@
+#include "include/test.t"
+
+var a = 2.0 as half;
+var b = 0.5 as half;
+var c = a * b;
+Test.Expect(c as float == 1.0);
+var v = float<4>(1.0, 2.0, 3.0, 65504.0) as half<4>;
+var w = (v + v) as float<4>;
+Test.Expect(w.x == 2.0);
+Test.Expect(w.y == 4.0);
+Test.Expect(w.z == 6.0);
+var d : float = a;
+Test.Expect(d == 2.0);
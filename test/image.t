@@ -1,5 +1,22 @@
 #include "include/test.t"
 
+class GreyImage {
+  // Checks the size of the image at the given scale, then decodes it into a buffer of exactly
+  // that size, and checks every pixel.
+  static Check(image : *Image<RGBA8unorm>, scale : uint, width : uint, height : uint) : bool {
+    var size = image.GetSize(scale);
+    if (size.x != width || size.y != height) { return false; }
+    var pixels = [width * height] new writeonly ubyte<4>;
+    image.Decode(pixels, width, scale);
+    for (var i = 0; i < pixels.length; ++i) {
+      var p = pixels[i];
+      if (p.r as uint != 190u || p.g as uint != 190u || p.b as uint != 190u) { return false; }
+      if (p.a as uint != 255u) { return false; }
+    }
+    return true;
+  }
+}
+
 var image = new Image<RGBA8unorm>(null);
 Test.Expect(image == null);
 
@@ -26,3 +43,34 @@ Test.Expect(d[0].r as uint == 190u);
 Test.Expect(d[0].g as uint == 190u);
 Test.Expect(d[0].b as uint == 190u);
 Test.Expect(d[0].a as uint == 255u);
+
+// Decoding the same image again, at each scale, re-reads the header. The dimensions are not
+// multiples of the scale, so the scaled sizes round up.
+var grey = new Image<RGBA8unorm>(inline("test/include/grey-20x18.jpg"));
+Test.Expect(GreyImage.Check(grey, 1u, 20u, 18u));
+Test.Expect(GreyImage.Check(grey, 2u, 10u, 9u));
+Test.Expect(GreyImage.Check(grey, 4u, 5u, 5u));
+Test.Expect(GreyImage.Check(grey, 8u, 3u, 3u));
+
+// Other scales are rejected by both GetSize() and Decode().
+var badSize = grey.GetSize(3u);
+Test.Expect(badSize.x == 0u && badSize.y == 0u);
+d[0] = ubyte<4>{};
+image.Decode(d, 1, 3u);
+Test.Expect(d[0].a as uint == 0u);
+
+// Several decodes in flight at once, each into its own buffer.
+var images : [4]*Image<RGBA8unorm>;
+var buffers : [4]*[]ubyte<4>;
+var requests : [4]*DecodeRequest;
+for (var i = 0; i < 4; ++i) {
+  images[i] = new Image<RGBA8unorm>(data);
+  buffers[i] = [1] new ubyte<4>;
+  requests[i] = images[i].DecodeAsync(buffers[i], 1);
+}
+for (var i = 0; i < 4; ++i) {
+  Test.Expect(requests[i].Wait());
+  Test.Expect(requests[i].IsReady());
+  Test.Expect(buffers[i][0].r as uint == 190u);
+  Test.Expect(buffers[i][0].a as uint == 255u);
+}
@@ -0,0 +1,22 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    bindings.Get().buffer.MapWrite()[0] = 1;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var first = new ComputePipeline<Compute>(device);
+var misses = device.GetPipelineCacheMisses();
+var hits = device.GetPipelineCacheHits();
+
+var second = new ComputePipeline<Compute>(device);
+Test.Expect(device.GetPipelineCacheMisses() == misses);
+Test.Expect(device.GetPipelineCacheHits() == hits + 1);
@@ -0,0 +1,37 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    buffer[0] = 42;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+var queue = device.GetQueue();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+var storageBuf = new storage Buffer<[]int>(device, 1);
+var readbackBuf = new hostreadable Buffer<[]int>(device, 1);
+var bg = new BindGroup<ComputeBindings>(device, {buffer = storageBuf});
+
+// The second command buffer reads what the first one wrote, so they must run in order.
+var computeEncoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(computeEncoder, {bindings = bg});
+computePass.SetPipeline(computePipeline);
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+var copyEncoder = new CommandEncoder(device);
+readbackBuf.CopyFromBuffer(copyEncoder, storageBuf);
+var commandBuffers = [2]*CommandBuffer{ computeEncoder.Finish(), copyEncoder.Finish() };
+queue.Submit(&commandBuffers);
+
+var fence = queue.OnSubmittedWorkDone();
+Test.Expect(fence.Wait());
+Test.Expect(fence.IsReady());
+Test.Expect(readbackBuf.MapRead()[0] == 42);
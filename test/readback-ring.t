@@ -0,0 +1,73 @@
+#include "include/test.t"
+
+class ComputeBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+class Compute {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var buffer = bindings.Get().buffer.MapWrite();
+    buffer[0] = 42;
+  }
+  var bindings : *BindGroup<ComputeBindings>;
+}
+
+var device = new Device();
+
+var computePipeline = new ComputePipeline<Compute>(device);
+
+var storageBuf = new storage Buffer<[]int>(device, 1);
+
+var bg = new BindGroup<ComputeBindings>(device, {buffer = storageBuf});
+
+var ring = new ReadbackRing<[]int>(device, 1);
+
+var encoder = new CommandEncoder(device);
+var computePass = new ComputePass<Compute>(encoder, {bindings = bg});
+computePass.SetPipeline(computePipeline);
+computePass.Dispatch(1, 1, 1);
+computePass.End();
+Test.Expect(ring.Copy(encoder, storageBuf));
+device.GetQueue().Submit(encoder.Finish());
+
+// Poll a bounded number of times, so that a failed map fails the test rather than hanging it.
+var result = ring.GetLatest();
+for (var tries = 0; result == null && tries < 1000000; ++tries) {
+  result = ring.GetLatest();
+}
+Test.Assert(result != null);
+Test.Expect(result[0] == 42);
+Test.Expect(ring.GetLatestFrame() == 0u);
+
+// GetLatest() before the copy is submitted must not map the slot.
+var ring3 = new ReadbackRing<[]int>(device, 1, 3);
+var data = [1] new int;
+encoder = new CommandEncoder(device);
+Test.Expect(ring3.Copy(encoder, storageBuf));
+Test.Expect(ring3.GetLatest() == null);
+device.GetQueue().Submit(encoder.Finish());
+
+// Keep three frames in flight, each copying a different value.
+for (var i = 1; i < 3; ++i) {
+  data[0] = i;
+  storageBuf.Set(data);
+  encoder = new CommandEncoder(device);
+  Test.Expect(ring3.Copy(encoder, storageBuf));
+  device.GetQueue().Submit(encoder.Finish());
+}
+// Every slot is in flight, so there is nowhere to copy to.
+encoder = new CommandEncoder(device);
+Test.Expect(!ring3.Copy(encoder, storageBuf));
+
+// Frames may become ready out of order, but the newest one eventually wins, and the latest
+// frame never moves backwards.
+result = ring3.GetLatest();
+var lastFrame = ring3.GetLatestFrame();
+for (var tries = 0; (result == null || ring3.GetLatestFrame() != 2u) && tries < 1000000; ++tries) {
+  result = ring3.GetLatest();
+  Test.Expect(ring3.GetLatestFrame() >= lastFrame);
+  lastFrame = ring3.GetLatestFrame();
+}
+Test.Assert(result != null);
+Test.Expect(ring3.GetLatestFrame() == 2u);
+Test.Expect(result[0] == 2);
@@ -0,0 +1,58 @@
+#include "include/test.t"
+
+class DrawPipeline {
+  vertex main(vb : &VertexBuiltins) { vb.position = {@vertices.Get(), 0.0, 1.0}; }
+  fragment main(fb : &FragmentBuiltins) { fragColor.Set( {0.0, 1.0, 0.0, 1.0} ); }
+  var vertices : *VertexInput<float<2>>;
+  var fragColor : *ColorOutput<RGBA8unorm>;
+}
+
+class CopyBindings {
+  var color : *SampleableTexture2D<float>;
+  var result : *storage Buffer<float<4>>;
+}
+
+class CopyPipeline {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var color = bindings.Get().color;
+    var result = bindings.Get().result.Map();
+    result: = color.Load(uint<2>{0u, 0u}, 0u);
+  }
+  var bindings : *BindGroup<CopyBindings>;
+}
+
+var device = new Device();
+var verts = [3]float<2>{ {-1.0, -1.0 }, { 3.0, -1.0 }, { -1.0, 3.0 } };
+var vb = new vertex Buffer<[]float<2>>(device, &verts);
+var vi = new VertexInput<float<2>>(vb);
+var drawPipeline = new RenderPipeline<DrawPipeline>(device);
+
+var bundleEncoder = new RenderBundleEncoder<DrawPipeline>(device);
+bundleEncoder.SetPipeline(drawPipeline);
+bundleEncoder.Set({ vertices = vi });
+bundleEncoder.Draw(3, 1, 0, 0);
+var bundles = [1]*RenderBundle<DrawPipeline>{ bundleEncoder.Finish() };
+
+var color = new renderable sampleable Texture2D<RGBA8unorm>(device, uint<2>(1, 1));
+var copyPipeline = new ComputePipeline<CopyPipeline>(device);
+var resultBuf = new storage Buffer<float<4>>(device, 1);
+var readbackBuf = new hostreadable Buffer<float<4>>(device, 1);
+var bindings = new BindGroup<CopyBindings>(device, {
+  color = color.CreateSampleableView(),
+  result = resultBuf
+});
+
+var encoder = new CommandEncoder(device);
+var renderPass = new RenderPass<DrawPipeline>(encoder, {
+  fragColor = color.CreateColorOutput(LoadOp.Clear)
+});
+renderPass.ExecuteBundles(&bundles);
+renderPass.End();
+var copyPass = new ComputePass<CopyPipeline>(encoder, { bindings = bindings });
+copyPass.SetPipeline(copyPipeline);
+copyPass.Dispatch(1, 1, 1);
+copyPass.End();
+readbackBuf.CopyFromBuffer(encoder, resultBuf);
+device.GetQueue().Submit(encoder.Finish());
+var result = readbackBuf.MapRead()[0];
+Test.Expect(result.y == 1.0);
@@ -0,0 +1,70 @@
+#include "include/test.t"
+
+class DrawPipeline {
+  vertex main(vb : &VertexBuiltins) : float<4> {
+    vb.position = {@vertices.Get(), 0.0, 1.0};
+    return colors.Get();
+  }
+  fragment main(fb : &FragmentBuiltins, varyings : float<4>) { fragColor.Set(varyings); }
+  var vertices : *VertexInput<float<2>>;
+  var colors : *PackedVertexInput<Unorm8x4>;
+  var fragColor : *ColorOutput<RGBA8unorm>;
+}
+
+class CopyBindings {
+  var color : *SampleableTexture2D<float>;
+  var result : *storage Buffer<float<4>>;
+}
+
+class CopyPipeline {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var color = bindings.Get().color;
+    var result = bindings.Get().result.Map();
+    result: = color.Load(uint<2>{0u, 0u}, 0u);
+  }
+  var bindings : *BindGroup<CopyBindings>;
+}
+
+var colors = [3]float<4>{ { 0.0, 1.0, 0.5, 1.0 }, { 0.0, 1.0, 0.5, 1.0 }, { 0.0, 1.0, 0.5, 1.0 } };
+var unorm8 : [3]ubyte<4>;
+VertexQuantizer.ToUnorm8x4(&colors, &unorm8);
+Test.Expect(unorm8[0].x == 0ub);
+Test.Expect(unorm8[0].y == 255ub);
+Test.Expect(unorm8[0].z == 128ub);
+var unorm10 : [3]uint;
+VertexQuantizer.ToUnorm10_10_10_2(&colors, &unorm10);
+Test.Expect(unorm10[0] == 3759143936u);  // a = 3, b = 512, g = 1023, r = 0
+
+var device = new Device();
+var verts = [3]float<2>{ {-1.0, -1.0 }, { 3.0, -1.0 }, { -1.0, 3.0 } };
+var vb = new vertex Buffer<[]float<2>>(device, &verts);
+var cb = new vertex Buffer<[]ubyte<4>>(device, &unorm8);
+var drawPipeline = new RenderPipeline<DrawPipeline>(device);
+
+var color = new renderable sampleable Texture2D<RGBA8unorm>(device, uint<2>(1, 1));
+var copyPipeline = new ComputePipeline<CopyPipeline>(device);
+var resultBuf = new storage Buffer<float<4>>(device, 1);
+var readbackBuf = new hostreadable Buffer<float<4>>(device, 1);
+var bindings = new BindGroup<CopyBindings>(device, {
+  color = color.CreateSampleableView(),
+  result = resultBuf
+});
+
+var encoder = new CommandEncoder(device);
+var renderPass = new RenderPass<DrawPipeline>(encoder, {
+  vertices = new VertexInput<float<2>>(vb),
+  colors = new PackedVertexInput<Unorm8x4>(cb),
+  fragColor = color.CreateColorOutput(LoadOp.Clear)
+});
+renderPass.SetPipeline(drawPipeline);
+renderPass.Draw(3, 1, 0, 0);
+renderPass.End();
+var copyPass = new ComputePass<CopyPipeline>(encoder, { bindings = bindings });
+copyPass.SetPipeline(copyPipeline);
+copyPass.Dispatch(1, 1, 1);
+copyPass.End();
+readbackBuf.CopyFromBuffer(encoder, resultBuf);
+device.GetQueue().Submit(encoder.Finish());
+var result = readbackBuf.MapRead()[0];
+Test.Expect(result.x == 0.0);
+Test.Expect(result.y == 1.0);
@@ -0,0 +1,19 @@
+#include "include/test.t"
+
+var device = new Device();
+var texture = new Texture2D<RGBA8unorm>(device, uint<2>(3, 2));
+var texels : [6]ubyte<4>;
+texels[5] = ubyte<4>{0ub, 255ub, 0ub, 255ub};
+texture.Write(&texels, uint<2>(3, 2));
+
+// Rows in the buffer are padded out to MinBufferWidth() texels.
+var width = texture.MinBufferWidth();
+var readbackBuf = new hostreadable Buffer<[]ubyte<4>>(device, width * 2u);
+var encoder = new CommandEncoder(device);
+texture.CopyToBuffer(encoder, readbackBuf, uint<2>(3, 2));
+device.GetQueue().Submit(encoder.Finish());
+var result = readbackBuf.MapRead();
+Test.Expect(result[0].g as uint == 0u);
+Test.Expect(result[width + 2u].r as uint == 0u);
+Test.Expect(result[width + 2u].g as uint == 255u);
+Test.Expect(result[width + 2u].a as uint == 255u);
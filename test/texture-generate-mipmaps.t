@@ -0,0 +1,68 @@
+#include "include/test.t"
+
+class CopyBindings {
+  var color : *SampleableTexture2D<float>;
+  var storageColor : *SampleableTexture2D<float>;
+  var floatColor : *unfilterable SampleableTexture2D<float>;
+  var arrayColor : *SampleableTexture2DArray<float>;
+  var result : *storage Buffer<[]float<4>>;
+}
+
+class CopyPipeline {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var b = bindings.Get();
+    var result = b.result.MapWrite();
+    result[0] = b.color.Load(uint<2>{0u, 0u}, 0u);
+    result[1] = b.storageColor.Load(uint<2>{0u, 0u}, 0u);
+    result[2] = b.floatColor.Load(uint<2>{0u, 0u}, 0u);
+    result[3] = b.arrayColor.Load(uint<2>{0u, 0u}, 0u, 0u);
+  }
+  var bindings : *BindGroup<CopyBindings>;
+}
+
+var device = new Device();
+// Two white and two black texels average to mid-grey in the 1x1 level.
+var texels = [4]ubyte<4>{ { 255ub, 255ub, 255ub, 255ub }, { 0ub, 0ub, 0ub, 255ub },
+                          { 0ub, 0ub, 0ub, 255ub }, { 255ub, 255ub, 255ub, 255ub } };
+var floatTexels = [4]float<4>{ { 1.0, 1.0, 1.0, 1.0 }, { 0.0, 0.0, 0.0, 1.0 },
+                               { 0.0, 0.0, 0.0, 1.0 }, { 1.0, 1.0, 1.0, 1.0 } };
+
+var texture = new renderable sampleable Texture2D<RGBA8unorm>(device, uint<2>(2, 2), 2u);
+texture.Write(&texels, uint<2>(2, 2));
+// Not renderable, so downsampled by a compute pass.
+var storageTexture = new storage sampleable Texture2D<RGBA8unorm>(device, uint<2>(2, 2), 2u);
+storageTexture.Write(&texels, uint<2>(2, 2));
+// Not filterable, so averaged without a linear sampler.
+var floatTexture = new renderable sampleable Texture2D<RGBA32float>(device, uint<2>(2, 2), 2u);
+floatTexture.Write(&floatTexels, uint<2>(2, 2));
+// Only layer 1 is written; each layer is filtered on its own.
+var arrayTexture =
+  new renderable sampleable Texture2DArray<RGBA8unorm>(device, uint<2>(2, 2), 2u, 2u);
+arrayTexture.Write(&texels, uint<2>(2, 2), 1u);
+
+var copyPipeline = new ComputePipeline<CopyPipeline>(device);
+var resultBuf = new storage Buffer<[]float<4>>(device, 4);
+var readbackBuf = new hostreadable Buffer<[]float<4>>(device, 4);
+var bindings = new BindGroup<CopyBindings>(device, {
+  color = texture.CreateSampleableView(1u, 1u),
+  storageColor = storageTexture.CreateSampleableView(1u, 1u),
+  floatColor = floatTexture.CreateSampleableView(1u, 1u),
+  arrayColor = arrayTexture.CreateSampleableView(1u, 1u, 1u, 1u),
+  result = resultBuf
+});
+var encoder = new CommandEncoder(device);
+texture.GenerateMipmaps(encoder);
+storageTexture.GenerateMipmaps(encoder);
+floatTexture.GenerateMipmaps(encoder);
+arrayTexture.GenerateMipmaps(encoder);
+var copyPass = new ComputePass<CopyPipeline>(encoder, { bindings = bindings });
+copyPass.SetPipeline(copyPipeline);
+copyPass.Dispatch(1, 1, 1);
+copyPass.End();
+readbackBuf.CopyFromBuffer(encoder, resultBuf);
+device.GetQueue().Submit(encoder.Finish());
+var results = readbackBuf.MapRead();
+for (var i = 0; i < 4; ++i) {
+  Test.Expect(results[i].x > 0.45 && results[i].x < 0.55);
+  Test.Expect(results[i].w == 1.0);
+}
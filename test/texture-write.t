@@ -0,0 +1,40 @@
+#include "include/test.t"
+
+class CopyBindings {
+  var color : *SampleableTexture2D<float>;
+  var result : *storage Buffer<float<4>>;
+}
+
+class CopyPipeline {
+  compute(1, 1, 1) main(cb : &ComputeBuiltins) {
+    var color = bindings.Get().color;
+    var result = bindings.Get().result.Map();
+    result: = color.Load(uint<2>{2u, 1u}, 0u);
+  }
+  var bindings : *BindGroup<CopyBindings>;
+}
+
+var device = new Device();
+// A 3x2 texture has 12-byte rows, far from the 256-byte alignment CopyFromBuffer requires.
+var texture = new sampleable Texture2D<RGBA8unorm>(device, uint<2>(3, 2));
+var texels : [6]ubyte<4>;
+texels[5] = ubyte<4>{0ub, 255ub, 0ub, 255ub};
+texture.Write(&texels, uint<2>(3, 2));
+
+var copyPipeline = new ComputePipeline<CopyPipeline>(device);
+var resultBuf = new storage Buffer<float<4>>(device, 1);
+var readbackBuf = new hostreadable Buffer<float<4>>(device, 1);
+var bindings = new BindGroup<CopyBindings>(device, {
+  color = texture.CreateSampleableView(),
+  result = resultBuf
+});
+var encoder = new CommandEncoder(device);
+var copyPass = new ComputePass<CopyPipeline>(encoder, { bindings = bindings });
+copyPass.SetPipeline(copyPipeline);
+copyPass.Dispatch(1, 1, 1);
+copyPass.End();
+readbackBuf.CopyFromBuffer(encoder, resultBuf);
+device.GetQueue().Submit(encoder.Finish());
+var result = readbackBuf.MapRead()[0];
+Test.Expect(result.x == 0.0);
+Test.Expect(result.y == 1.0);
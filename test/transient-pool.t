@@ -0,0 +1,63 @@
+#include "include/test.t"
+
+class PoolBindings {
+  var buffer : *storage Buffer<[]int>;
+}
+
+var device = new Device();
+var pool = new TransientPool(device);
+
+// A released texture is cached, and handed out again for a matching request.
+var texture = new sampleable renderable Texture2D<RGBA8unorm>(pool, uint<2>(4, 4));
+Test.Expect(pool.GetCachedBytes() == 0u);
+texture = null;
+Test.Expect(pool.GetCachedBytes() == 64u);
+texture = new sampleable renderable Texture2D<RGBA8unorm>(pool, uint<2>(4, 4));
+Test.Expect(pool.GetCachedBytes() == 0u);
+
+// A view keeps the texture out of the pool until it too is released.
+var view = texture.CreateSampleableView();
+texture = null;
+Test.Expect(pool.GetCachedBytes() == 0u);
+view = null;
+Test.Expect(pool.GetCachedBytes() == 64u);
+
+var buffer = new storage Buffer<[]int>(pool, 4);
+buffer = null;
+Test.Expect(pool.GetCachedBytes() == 80u);
+
+// Host-mappable buffers are never pooled.
+var readback = new hostreadable Buffer<[]int>(pool, 4);
+readback = null;
+Test.Expect(pool.GetCachedBytes() == 80u);
+
+// A bind group keeps its buffers out of the pool until it is released.
+buffer = new storage Buffer<[]int>(pool, 4);
+Test.Expect(pool.GetCachedBytes() == 64u);
+var bindGroup = new BindGroup<PoolBindings>(device, { buffer = buffer });
+buffer = null;
+Test.Expect(pool.GetCachedBytes() == 64u);
+bindGroup = null;
+Test.Expect(pool.GetCachedBytes() == 80u);
+
+// So does an encoder which uses them, until its commands are submitted.
+buffer = new storage Buffer<[]int>(pool, 4);
+var copy = new storage Buffer<[]int>(device, 4);
+var encoder = new CommandEncoder(device);
+copy.CopyFromBuffer(encoder, buffer);
+buffer = null;
+Test.Expect(pool.GetCachedBytes() == 64u);
+device.GetQueue().Submit(encoder.Finish());
+Test.Expect(pool.GetCachedBytes() == 80u);
+
+// Idle resources are destroyed after maxIdleFrames frames.
+for (var i = 0; i < 4; ++i) {
+  pool.NextFrame();
+}
+Test.Expect(pool.GetCachedBytes() == 0u);
+
+// Nothing larger than maxCachedBytes is kept.
+var smallPool = new TransientPool(device, 32u);
+texture = new renderable Texture2D<RGBA8unorm>(smallPool, uint<2>(4, 4));
+texture = null;
+Test.Expect(smallPool.GetCachedBytes() == 0u);